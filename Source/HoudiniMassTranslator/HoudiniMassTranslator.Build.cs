@@ -43,6 +43,7 @@ public class HoudiniMassTranslator : ModuleRules
                 "ToolMenus",
                 "UnrealEd",
                 "DeveloperToolSettings",
+                "DeveloperSettings",
             }
 			);
 		
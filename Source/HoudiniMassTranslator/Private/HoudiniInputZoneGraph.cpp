@@ -0,0 +1,332 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniInputZoneGraph.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "ZoneGraphData.h"
+
+#include "HoudiniApi.h"
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+#include "HoudiniMassCommon.h"
+
+
+bool FHoudiniZoneGraphDataInput::HapiDestroy(UHoudiniInput* Input) const  // Will then delete this, so we need NOT to reset node ids to -1
+{
+	if (NodeId >= 0)
+	{
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::DeleteNode(FHoudiniEngine::Get().GetSession(), NodeId));
+		Input->NotifyMergedNodeDestroyed();
+	}
+
+	return true;
+}
+
+bool FHoudiniZoneGraphDataInputBuilder::IsValidInput(const UActorComponent* Component)
+{
+	return IsValid(Component) && Component->GetOwner() && Component->GetOwner()->IsA<AZoneGraphData>() &&
+		(Component->GetOwner()->GetRootComponent() == Component);  // Only the root component represents the zone graph data
+}
+
+static uint32 GetZoneGraphStorageHash(const FZoneGraphStorage& Storage, const FTransform& Transform)
+{
+	const FVector Location = Transform.GetLocation();
+	const FQuat Rotation = Transform.GetRotation();
+	const FVector Scale = Transform.GetScale3D();
+	const double TransformValues[10] = { Location.X, Location.Y, Location.Z,
+		Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+	uint32 Hash = FCrc::MemCrc32(TransformValues, sizeof(TransformValues));
+
+	// FZoneData and FZoneLaneLinkData have padding bytes, so hash them field by field, the others are tightly packed, so we could hash them in bulk
+	for (const FZoneData& Zone : Storage.Zones)
+	{
+		const int32 ZoneValues[5] = { Zone.BoundaryPointsBegin, Zone.BoundaryPointsEnd, Zone.LanesBegin, Zone.LanesEnd, int32(Zone.Tags.GetValue()) };
+		Hash = FCrc::MemCrc32(ZoneValues, sizeof(ZoneValues), Hash);
+	}
+	Hash = FCrc::MemCrc32(Storage.Lanes.GetData(), Storage.Lanes.Num() * Storage.Lanes.GetTypeSize(), Hash);
+	Hash = FCrc::MemCrc32(Storage.LanePoints.GetData(), Storage.LanePoints.Num() * Storage.LanePoints.GetTypeSize(), Hash);
+	Hash = FCrc::MemCrc32(Storage.LaneUpVectors.GetData(), Storage.LaneUpVectors.Num() * Storage.LaneUpVectors.GetTypeSize(), Hash);
+	for (const FZoneLaneLinkData& Link : Storage.LaneLinks)
+	{
+		const int32 LinkValues[3] = { Link.DestLaneIndex, int32(Link.Type), int32(Link.Flags) };
+		Hash = FCrc::MemCrc32(LinkValues, sizeof(LinkValues), Hash);
+	}
+
+	return Hash;
+}
+
+struct FZoneGraphStorageBuffers  // Flat copies of FZoneGraphStorage in houdini space, so that we could upload them without holding the storage lock
+{
+	TArray<int32> VertexCounts;
+	TArray<float> Widths;
+	TArray<int32> Tags;
+	TArray<int32> Zones;
+	TArray<int32> LeftLanes;
+	TArray<int32> RightLanes;
+	TArray<int32> OutgoingCounts;
+	TArray<int32> IncomingCounts;
+	TArray<int32> Outgoings;
+	TArray<int32> Incomings;
+
+	TArray<float> Positions;
+	TArray<float> Normals;
+	TArray<float> Progressions;
+};
+
+static void ConvertZoneGraphStorage(const FZoneGraphStorage& Storage, const FTransform& Transform, FZoneGraphStorageBuffers& OutBuffers)
+{
+	const int32 NumLanes = Storage.Lanes.Num();
+	const int32 NumPoints = Storage.LanePoints.Num();
+
+	// -------- Convert lanes to flat buffers, lanes are the curves, and their points are contiguous in storage --------
+	TArray<int32>& VertexCounts = OutBuffers.VertexCounts;
+	TArray<float>& Widths = OutBuffers.Widths;
+	TArray<int32>& Tags = OutBuffers.Tags;
+	TArray<int32>& Zones = OutBuffers.Zones;
+	TArray<int32>& LeftLanes = OutBuffers.LeftLanes;
+	TArray<int32>& RightLanes = OutBuffers.RightLanes;
+	TArray<int32>& OutgoingCounts = OutBuffers.OutgoingCounts;
+	TArray<int32>& IncomingCounts = OutBuffers.IncomingCounts;
+	VertexCounts.SetNumUninitialized(NumLanes);
+	Widths.SetNumUninitialized(NumLanes);
+	Tags.SetNumUninitialized(NumLanes);
+	Zones.SetNumUninitialized(NumLanes);
+	LeftLanes.SetNumUninitialized(NumLanes);
+	RightLanes.SetNumUninitialized(NumLanes);
+	OutgoingCounts.SetNumZeroed(NumLanes);
+	IncomingCounts.SetNumZeroed(NumLanes);
+	TArray<int32>& Outgoings = OutBuffers.Outgoings;
+	TArray<int32>& Incomings = OutBuffers.Incomings;
+	for (int32 LaneIdx = 0; LaneIdx < NumLanes; ++LaneIdx)
+	{
+		const FZoneLaneData& Lane = Storage.Lanes[LaneIdx];
+		VertexCounts[LaneIdx] = Lane.PointsEnd - Lane.PointsBegin;
+		Widths[LaneIdx] = Lane.Width * POSITION_SCALE_TO_HOUDINI;
+		Tags[LaneIdx] = int32(Lane.Tags.GetValue());
+		Zones[LaneIdx] = Lane.ZoneIndex;
+		LeftLanes[LaneIdx] = -1;
+		RightLanes[LaneIdx] = -1;
+		for (int32 LinkIdx = Lane.LinksBegin; LinkIdx < Lane.LinksEnd; ++LinkIdx)
+		{
+			const FZoneLaneLinkData& Link = Storage.LaneLinks[LinkIdx];
+			switch (Link.Type)
+			{
+			case EZoneLaneLinkType::Outgoing: Outgoings.Add(Link.DestLaneIndex); ++OutgoingCounts[LaneIdx]; break;
+			case EZoneLaneLinkType::Incoming: Incomings.Add(Link.DestLaneIndex); ++IncomingCounts[LaneIdx]; break;
+			case EZoneLaneLinkType::Adjacent:
+			{
+				if (Link.HasFlags(EZoneLaneLinkFlags::Left) && (LeftLanes[LaneIdx] < 0))
+					LeftLanes[LaneIdx] = Link.DestLaneIndex;
+				else if (Link.HasFlags(EZoneLaneLinkFlags::Right) && (RightLanes[LaneIdx] < 0))
+					RightLanes[LaneIdx] = Link.DestLaneIndex;
+			}
+			break;
+			default: break;
+			}
+		}
+	}
+
+	const bool bIsIdentity = Transform.Equals(FTransform::Identity);
+	TArray<float>& Positions = OutBuffers.Positions;
+	TArray<float>& Normals = OutBuffers.Normals;
+	TArray<float>& Progressions = OutBuffers.Progressions;
+	Positions.SetNumUninitialized(NumPoints * 3);
+	Normals.SetNumUninitialized(NumPoints * 3);
+	Progressions.SetNumUninitialized(NumPoints);
+	ParallelFor(NumPoints, [&](int32 PointIdx)
+		{
+			const FVector3f Pos = FVector3f((bIsIdentity ? Storage.LanePoints[PointIdx] : Transform.TransformPosition(Storage.LanePoints[PointIdx])) * POSITION_SCALE_TO_HOUDINI);
+			Positions[PointIdx * 3] = Pos.X;
+			Positions[PointIdx * 3 + 1] = Pos.Z;
+			Positions[PointIdx * 3 + 2] = Pos.Y;
+
+			const FVector3f Normal = FVector3f(bIsIdentity ? Storage.LaneUpVectors[PointIdx] : Transform.TransformVectorNoScale(Storage.LaneUpVectors[PointIdx]));
+			Normals[PointIdx * 3] = Normal.X;
+			Normals[PointIdx * 3 + 1] = Normal.Z;
+			Normals[PointIdx * 3 + 2] = Normal.Y;
+
+			Progressions[PointIdx] = Storage.LanePointProgressions[PointIdx] * POSITION_SCALE_TO_HOUDINI;
+		});
+}
+
+static bool HapiUploadZoneGraphBuffers(UHoudiniInput* Input, int32& NodeId, const FString& Name, const FZoneGraphStorageBuffers& Buffers)
+{
+	const bool bCreateNewNode = (NodeId < 0);
+	if (bCreateNewNode)
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
+			TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_zone_graph_%08X"), *Name, FPlatformTime::Cycles())), false, &NodeId));
+
+	HAPI_PartInfo PartInfo;
+	FHoudiniApi::PartInfo_Init(&PartInfo);
+	PartInfo.type = HAPI_PARTTYPE_CURVE;
+	PartInfo.faceCount = Buffers.VertexCounts.Num();
+	PartInfo.pointCount = Buffers.Progressions.Num();
+	PartInfo.vertexCount = Buffers.Progressions.Num();
+
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_InputShapes, PartInfo.faceCount);
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_InputPoints, PartInfo.pointCount);
+
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+
+	{
+		HAPI_CurveInfo CurveInfo;
+		FHoudiniApi::CurveInfo_Init(&CurveInfo);
+		CurveInfo.curveType = HAPI_CURVETYPE_LINEAR;
+		CurveInfo.curveCount = PartInfo.faceCount;
+		CurveInfo.vertexCount = PartInfo.vertexCount;
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetCurveInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &CurveInfo));
+
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetCurveCounts(
+			FHoudiniEngine::Get().GetSession(), NodeId, 0, Buffers.VertexCounts.GetData(), 0, PartInfo.faceCount));
+	}
+
+	HAPI_AttributeInfo AttributeInfo;
+	FHoudiniApi::AttributeInfo_Init(&AttributeInfo);
+	AttributeInfo.exists = true;
+	AttributeInfo.originalOwner = HAPI_ATTROWNER_INVALID;
+
+	auto HapiSetFloatAttribLambda = [&](const char* AttribName, const HAPI_AttributeOwner& Owner, const int32& TupleSize, const TArray<float>& Data) -> bool
+		{
+			AttributeInfo.count = (Owner == HAPI_ATTROWNER_POINT) ? PartInfo.pointCount : PartInfo.faceCount;
+			AttributeInfo.tupleSize = TupleSize;
+			AttributeInfo.owner = Owner;
+			AttributeInfo.storage = HAPI_STORAGETYPE_FLOAT;
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo));
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo, Data.GetData(), 0, AttributeInfo.count));
+
+			return true;
+		};
+
+	auto HapiSetPrimIntAttribLambda = [&](const char* AttribName, const TArray<int32>& Data) -> bool
+		{
+			AttributeInfo.count = PartInfo.faceCount;
+			AttributeInfo.tupleSize = 1;
+			AttributeInfo.owner = HAPI_ATTROWNER_PRIM;
+			AttributeInfo.storage = HAPI_STORAGETYPE_INT;
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo));
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo, Data.GetData(), 0, AttributeInfo.count));
+
+			return true;
+		};
+
+	auto HapiSetPrimIntArrayAttribLambda = [&](const char* AttribName, const TArray<int32>& Data, const TArray<int32>& Counts) -> bool
+		{
+			static const int32 SpareData = -1;
+
+			AttributeInfo.count = PartInfo.faceCount;
+			AttributeInfo.tupleSize = 1;
+			AttributeInfo.owner = HAPI_ATTROWNER_PRIM;
+			AttributeInfo.storage = HAPI_STORAGETYPE_INT_ARRAY;
+			AttributeInfo.totalArrayElements = Data.Num();
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo));
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeIntArrayData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+				AttribName, &AttributeInfo, (Data.IsEmpty() ? &SpareData : Data.GetData()), Data.Num(), Counts.GetData(), 0, AttributeInfo.count));
+
+			AttributeInfo.totalArrayElements = 0;
+
+			return true;
+		};
+
+	HOUDINI_FAIL_RETURN(HapiSetFloatAttribLambda(HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, 3, Buffers.Positions));  // @P
+	HOUDINI_FAIL_RETURN(HapiSetFloatAttribLambda(HAPI_ATTRIB_NORMAL, HAPI_ATTROWNER_POINT, 3, Buffers.Normals));  // @N, lane up vectors
+	HOUDINI_FAIL_RETURN(HapiSetFloatAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_PROGRESSION, HAPI_ATTROWNER_POINT, 1, Buffers.Progressions));
+	HOUDINI_FAIL_RETURN(HapiSetFloatAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, HAPI_ATTROWNER_PRIM, 1, Buffers.Widths));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_TAGS, Buffers.Tags));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_GRAPH_ZONE, Buffers.Zones));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_LEFT, Buffers.LeftLanes));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_RIGHT, Buffers.RightLanes));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntArrayAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_OUTGOING, Buffers.Outgoings, Buffers.OutgoingCounts));
+	HOUDINI_FAIL_RETURN(HapiSetPrimIntArrayAttribLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_INCOMING, Buffers.Incomings, Buffers.IncomingCounts));
+
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+
+	if (bCreateNewNode)
+		HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+
+	return true;
+}
+
+bool FHoudiniZoneGraphDataInputBuilder::HapiUpload(UHoudiniInput* Input, const bool& bIsSingleComponent,  // Is there only one single valid component in the whole blueprint/actor
+	const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,  // Components and Transforms are all of the components in blueprint/actor, and ComponentIndices are ref the valid indices from IsValidInput
+	int32& InOutInstancerNodeId, TArray<TSharedPtr<FHoudiniComponentInput>>& InOutComponentInputs, TArray<FHoudiniComponentInputPoint>& InOutPoints)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniInputZoneGraph);
+
+	if (ComponentIndices.IsEmpty())
+		return true;
+
+	TSharedPtr<FHoudiniZoneGraphDataInput> ZGDInput;
+	if (InOutComponentInputs.IsValidIndex(0))
+		ZGDInput = StaticCastSharedPtr<FHoudiniZoneGraphDataInput>(InOutComponentInputs[0]);
+	else
+	{
+		ZGDInput = MakeShared<FHoudiniZoneGraphDataInput>();
+		InOutComponentInputs.Add(ZGDInput);
+	}
+
+	const int32& CompIdx = ComponentIndices[0];  // Only one root component of an AZoneGraphData
+	const AZoneGraphData* ZGD = CastChecked<AZoneGraphData>(Components[CompIdx]->GetOwner());
+
+	// Lanes are in world space, so transform them into the space of the input transforms
+	const USceneComponent* SceneComponent = Cast<USceneComponent>(Components[CompIdx]);
+	const FTransform WorldToInput = SceneComponent ? (SceneComponent->GetComponentTransform().Inverse() * Transforms[CompIdx]) : FTransform::Identity;
+
+	// Only hold the storage lock while reading the storage, NOT through the HAPI calls, so that zone graph queries will NOT be blocked by the upload
+	uint32 StorageHash = 0;
+	FZoneGraphStorageBuffers Buffers;
+	{
+		FScopeLock Lock(&ZGD->GetStorageLock());
+		const FZoneGraphStorage& Storage = ZGD->GetStorage();
+
+		StorageHash = GetZoneGraphStorageHash(Storage, WorldToInput);
+		if ((ZGDInput->NodeId >= 0) && (ZGDInput->StorageHash == StorageHash))
+			return true;
+
+		ConvertZoneGraphStorage(Storage, WorldToInput, Buffers);
+	}
+
+	ZGDInput->StorageHash = 0;  // Mark dirty until the upload succeeded
+	HOUDINI_FAIL_RETURN(HapiUploadZoneGraphBuffers(Input, ZGDInput->NodeId, ZGD->GetName(), Buffers));
+	ZGDInput->StorageHash = StorageHash;
+
+	return true;
+}
+
+void FHoudiniZoneGraphDataInputBuilder::AppendInfo(const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,  // See the comment upon
+	const TSharedPtr<FJsonObject>& JsonObject)  // Append object info to JsonObject, keys are instance refs, values are JsonObjects that contain transoforms and meta data
+{
+	for (const int32& CompIdx : ComponentIndices)
+	{
+		const AZoneGraphData* ZGD = CastChecked<AZoneGraphData>(Components[CompIdx]->GetOwner());
+
+		// Transform in houdini space
+		const FTransform& Transform = Transforms[CompIdx];
+		const FVector Position = Transform.GetLocation() * POSITION_SCALE_TO_HOUDINI;
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Scale = Transform.GetScale3D();
+
+		TArray<TSharedPtr<FJsonValue>> JsonPosition = { MakeShared<FJsonValueNumber>(Position.X), MakeShared<FJsonValueNumber>(Position.Z), MakeShared<FJsonValueNumber>(Position.Y) };
+		TArray<TSharedPtr<FJsonValue>> JsonRotation = { MakeShared<FJsonValueNumber>(Rotation.X), MakeShared<FJsonValueNumber>(Rotation.Z), MakeShared<FJsonValueNumber>(Rotation.Y), MakeShared<FJsonValueNumber>(-Rotation.W) };
+		TArray<TSharedPtr<FJsonValue>> JsonScale = { MakeShared<FJsonValueNumber>(Scale.X), MakeShared<FJsonValueNumber>(Scale.Z), MakeShared<FJsonValueNumber>(Scale.Y) };
+
+		TSharedPtr<FJsonObject> JsonZGD = MakeShared<FJsonObject>();
+		JsonZGD->SetStringField(TEXT("name"), ZGD->GetName());
+		JsonZGD->SetArrayField(TEXT("P"), JsonPosition);
+		JsonZGD->SetArrayField(TEXT("orient"), JsonRotation);
+		JsonZGD->SetArrayField(TEXT("scale"), JsonScale);
+		JsonObject->SetObjectField(ZGD->GetPathName(), JsonZGD);
+	}
+}
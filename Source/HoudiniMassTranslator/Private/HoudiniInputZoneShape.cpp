@@ -2,6 +2,7 @@
 
 #include "HoudiniInputZoneShape.h"
 
+#include "Async/ParallelFor.h"
 #include "ZoneGraphSettings.h"
 #include "ZoneShapeComponent.h"
 
@@ -9,15 +10,30 @@
 #include "HoudiniEngine.h"
 #include "HoudiniEngineUtils.h"
 
+#include "HoudiniMassTranslator.h"
 #include "HoudiniMassCommon.h"
+#include "HoudiniMassConversion.h"
+#include "HoudiniMassSettings.h"
+#include "HoudiniZoneGraphSettingsCache.h"
+#include "HoudiniZoneShapeRegion.h"
+#include "HoudiniZoneShapeSpatialIndex.h"
 
 
+DECLARE_CYCLE_STAT(TEXT("Input: Region Query"), STAT_HoudiniMass_InputRegionQuery, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Input: Classify and Hash"), STAT_HoudiniMass_InputClassify, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Input: Gather"), STAT_HoudiniMass_InputGather, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Input: Encode Strings"), STAT_HoudiniMass_InputEncode, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Input: Set Attributes and Commit"), STAT_HoudiniMass_InputSetAttributes, STATGROUP_HoudiniMass);
+
 bool FHoudiniZoneShapeComponentInput::HapiDestroy(UHoudiniInput* Input) const  // Will then delete this, so we need NOT to reset node ids to -1
 {
-	if (NodeId >= 0)
+	for (const auto& Bucket : Buckets)
 	{
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::DeleteNode(FHoudiniEngine::Get().GetSession(), NodeId));
-		Input->NotifyMergedNodeDestroyed();
+		if (Bucket.Value.NodeId >= 0)
+		{
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::DeleteNode(FHoudiniEngine::Get().GetSession(), Bucket.Value.NodeId));
+			Input->NotifyMergedNodeDestroyed();
+		}
 	}
 
 	return true;
@@ -25,170 +41,317 @@ bool FHoudiniZoneShapeComponentInput::HapiDestroy(UHoudiniInput* Input) const  /
 
 bool FHoudiniZoneShapeComponentInputBuilder::IsValidInput(const UActorComponent* Component)
 {
-	return IsValid(Component) && Component->IsA<UZoneShapeComponent>();
-}
-
-uint32 GetTypeHash(const FZoneLaneDesc& Lane)
-{
-	return GetTypeHash(TArray<uint8>((uint8*)&Lane, sizeof(FZoneLaneDesc)));
+	return IsValid(Component) && (Component->IsA<UZoneShapeComponent>() || Component->IsA<UHoudiniZoneShapeRegionComponent>());
 }
 
-static const char* ConvertLaneToJsonStr(const FZoneLaneDesc& Lane, const UZoneGraphSettings* ZoneGraphSettings, TMap<FZoneLaneDesc, std::string>& InOutLaneDictStrMap)
+static uint32 GetZoneGraphSettingsHash(const UZoneGraphSettings* ZoneGraphSettings)
 {
-	if (const std::string* FoundStrPtr = InOutLaneDictStrMap.Find(Lane))
-		return FoundStrPtr->c_str();
-	else {
-		FString TagsStr = TEXT("[");
-		for (const FZoneGraphTagInfo& Tag : ZoneGraphSettings->GetTagInfos())
-		{
-			if (Lane.Tags.Contains(Tag.Tag))
-				TagsStr += TEXT("\"") + Tag.Name.ToString() + TEXT("\",");
-		}
-		TagsStr.RemoveFromEnd(TEXT(","));
-		TagsStr += TEXT("]");
+	uint32 Hash = 0;
+	for (const FZoneGraphTagInfo& Tag : ZoneGraphSettings->GetTagInfos())
+		Hash = HashCombineFast(Hash, GetTypeHash(Tag.Name));
 
-		return InOutLaneDictStrMap.Add(Lane, TCHAR_TO_UTF8(*FString::Printf(TEXT("{\"Width\":%f,\"Direction\":%d,\"Tags\":%s}"),
-			Lane.Width * POSITION_SCALE_TO_HOUDINI, int32(Lane.Direction), *TagsStr))).c_str();
+	for (const FZoneLaneProfile& LaneProfile : ZoneGraphSettings->GetLaneProfiles())
+	{
+		Hash = HashCombineFast(Hash, GetTypeHash(LaneProfile.ID));
+		Hash = HashCombineFast(Hash, GetTypeHash(LaneProfile.Name));
+		for (const FZoneLaneDesc& Lane : LaneProfile.Lanes)
+			Hash = HashCombineFast(Hash, FHoudiniZoneGraphSettingsCache::GetLaneHash(Lane));
 	}
 
-	return "";
+	return Hash;
 }
 
-bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, const bool& bIsSingleComponent,  // Is there only one single valid component in the whole blueprint/actor
-	const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,  // Components and Transforms are all of the components in blueprint/actor, and ComponentIndices are ref the valid indices from IsValidInput
-	int32& InOutInstancerNodeId, TArray<TSharedPtr<FHoudiniComponentInput>>& InOutComponentInputs, TArray<FHoudiniComponentInputPoint>& InOutPoints)
+static uint32 GetZoneShapeComponentHash(const UZoneShapeComponent* ZSC, const FTransform& Transform)
 {
-	TSharedPtr<FHoudiniZoneShapeComponentInput> ZSCInput;
-	if (InOutComponentInputs.IsValidIndex(0))
-		ZSCInput = StaticCastSharedPtr<FHoudiniZoneShapeComponentInput>(InOutComponentInputs[0]);
-	else
+	// Only hash what we will upload, lane profile refs are enough as the profile contents are covered by GetZoneGraphSettingsHash
+	const FVector Location = Transform.GetLocation();
+	const FQuat Rotation = Transform.GetRotation();
+	const FVector Scale = Transform.GetScale3D();
+	const double TransformValues[10] = { Location.X, Location.Y, Location.Z,
+		Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+	uint32 Hash = FCrc::MemCrc32(TransformValues, sizeof(TransformValues));
+
+	Hash = HashCombineFast(Hash, GetTypeHash(uint8(ZSC->GetShapeType())));
+	Hash = HashCombineFast(Hash, GetTypeHash(uint8(ZSC->IsLaneProfileReversed())));
+	Hash = HashCombineFast(Hash, GetTypeHash(ZSC->GetCommonLaneProfile().ID));
+	for (const FZoneLaneProfileRef& LaneProfileRef : ZSC->GetPerPointLaneProfiles())
+		Hash = HashCombineFast(Hash, GetTypeHash(LaneProfileRef.ID));
+
+	for (const FZoneShapePoint& Point : ZSC->GetPoints())
 	{
-		ZSCInput = MakeShared<FHoudiniZoneShapeComponentInput>();
-		InOutComponentInputs.Add(ZSCInput);
+		const double PointValues[6] = { Point.Position.X, Point.Position.Y, Point.Position.Z,
+			Point.Rotation.Pitch, Point.Rotation.Yaw, Point.Rotation.Roll };
+		Hash = FCrc::MemCrc32(PointValues, sizeof(PointValues), Hash);
+		Hash = HashCombineFast(Hash, GetTypeHash(Point.LaneProfile));
 	}
 
-	int32& NodeId = ZSCInput->NodeId;
-	const bool bCreateNewNode = (NodeId < 0);
-	if (bCreateNewNode)
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
-			TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_zone_shape_%08X"), *(Components[ComponentIndices[0]]->GetOuter()->GetName()), FPlatformTime::Cycles())),
-			false, &NodeId));
+	// Only which connector of which shape is connected, as the uploaded connectivity attribs do NOT depend on the transforms of neighbors.
+	// A neighbor that moves but stays connected will NOT re-upload this shape
+	for (const FZoneShapeConnection& Connection : ZSC->GetConnectedShapes())
+	{
+		Hash = HashCombineFast(Hash, GetTypeHash(Connection.ShapeComponent));
+		Hash = HashCombineFast(Hash, GetTypeHash(Connection.ConnectorIndex));
+	}
 
-	HAPI_PartInfo PartInfo;
-	FHoudiniApi::PartInfo_Init(&PartInfo);
-	PartInfo.type = HAPI_PARTTYPE_CURVE;
-	PartInfo.faceCount = ComponentIndices.Num();
+	return Hash;
+}
 
-	const UZoneGraphSettings* ZoneGraphSettings = GetDefault<UZoneGraphSettings>();
+void FHoudiniZoneShapesInputData::Gather(const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices)
+{
+	const int32 NumComponents = ComponentIndices.Num();
 
-	TArray<int32> VertexCounts;
-	TArray<int32> ZoneShapeTypes;
-	TArray<float> Positions;
-	TArray<float> Rotations;
+	// -------- First pass: resolve lane profiles, and count points and lanes of each component --------
+	struct FZoneShapeGatherInfo
+	{
+		int32 PointOffset = 0;
+		int32 SplineLaneOffset = 0;
+		int32 PointLaneOffset = 0;
+		int32 NumPointLanes = 0;
+		int32 NumConnectors = 0;
 
-	// s@unreal_zone_lane_profile_name
-	TMap<FName, std::string> LaneProfileNameStrMap;
-	TArray<const char*> PointLaneProfileNames;
-	TArray<const char*> SplineLaneProfileNames;
-	SplineLaneProfileNames.Reserve(PartInfo.faceCount);
+		FZoneLaneProfile SplineLaneProfile;  // Also the inherited lane profile of polygon points
+		TArray<FZoneLaneProfile> PolygonLaneProfiles;
 
-	// d[]@unreal_zone_lane_profile
-	TMap<FZoneLaneDesc, std::string> LaneDictStrMap;
-	TArray<const char*> PointLanes;
-	TArray<int32> PointLaneCounts;
-	TArray<const char*> SplineLanes;
-	TArray<int32> SplineLaneCounts;
-	SplineLaneCounts.Reserve(PartInfo.faceCount);
-
-	bool bHasPolygon = false;
-	bool bHasSpline = false;
-	for (const int32& CompIdx : ComponentIndices)
+		FORCEINLINE const FZoneLaneProfile* GetPointLaneProfile(const FZoneShapePoint& Point) const
+		{
+			if (Point.LaneProfile == FZoneShapePoint::InheritLaneProfile)
+				return &SplineLaneProfile;
+			return PolygonLaneProfiles.IsValidIndex(Point.LaneProfile) ? &PolygonLaneProfiles[Point.LaneProfile] : nullptr;
+		}
+	};
+
+	TArray<FZoneShapeGatherInfo> GatherInfos;
+	GatherInfos.SetNum(NumComponents);
 	{
-		const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(Components[CompIdx]);
-		const FTransform& Transform = Transforms[CompIdx];
-		ZoneShapeTypes.Add((int32)ZSC->GetShapeType());
-		VertexCounts.Add(ZSC->GetPoints().Num());
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputGather);
+		ParallelFor(NumComponents, [&](int32 Idx)
+			{
+				const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(Components[ComponentIndices[Idx]]);
+				FZoneShapeGatherInfo& Info = GatherInfos[Idx];
+				Info.NumConnectors = ZSC->GetShapeConnectors().Num();
+				ZSC->GetSplineLaneProfile(Info.SplineLaneProfile);
+				if (ZSC->GetShapeType() == FZoneShapeType::Polygon)
+				{
+					ZSC->GetPolygonLaneProfiles(Info.PolygonLaneProfiles);
+					for (const FZoneShapePoint& Point : ZSC->GetPoints())
+					{
+						if (const FZoneLaneProfile* LaneProfilePtr = Info.GetPointLaneProfile(Point))
+							Info.NumPointLanes += LaneProfilePtr->Lanes.Num();
+					}
+				}
+			});
+	}
 
-		const int32 NumPoints = ZSC->GetPoints().Num();
+	// -------- Accumulate offsets --------
+	bHasPolygon = false;
+	bHasSpline = false;
+	NumPoints = 0;
+	int32 NumSplineLanes = 0;
+	int32 NumPointLanes = 0;
+	NumConnectors = 0;
+	TMap<const UZoneShapeComponent*, int32> ZSCPrimIdxMap;  // For i@unreal_zone_shape_connected_prim
+	for (int32 Idx = 0; Idx < NumComponents; ++Idx)
+	{
+		const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(Components[ComponentIndices[Idx]]);
+		FZoneShapeGatherInfo& Info = GatherInfos[Idx];
+		NumConnectors += Info.NumConnectors;
+		ZSCPrimIdxMap.Add(ZSC, Idx);
+		Info.PointOffset = NumPoints;
+		Info.SplineLaneOffset = NumSplineLanes;
+		Info.PointLaneOffset = NumPointLanes;
+
+		NumPoints += ZSC->GetPoints().Num();
 		if (ZSC->GetShapeType() == FZoneShapeType::Spline)
 		{
 			bHasSpline = true;
-
-			// Spline LaneProfile
-			FZoneLaneProfile LaneProfile;
-			ZSC->GetSplineLaneProfile(LaneProfile);
-			if (const std::string* FoundStrPtr = LaneProfileNameStrMap.Find(LaneProfile.Name))
-				SplineLaneProfileNames.Add(FoundStrPtr->c_str());
-			else
-				SplineLaneProfileNames.Add(
-					LaneProfileNameStrMap.Add(LaneProfile.Name, LaneProfile.Name.IsNone() ? "" : TCHAR_TO_UTF8(*LaneProfile.Name.ToString())).c_str());
-
-			SplineLaneCounts.Add(LaneProfile.Lanes.Num());
-			for (const FZoneLaneDesc& Lane : LaneProfile.Lanes)
-				SplineLanes.Add(ConvertLaneToJsonStr(Lane, ZoneGraphSettings, LaneDictStrMap));
-
-			// Point LaneProfiles
-			for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
-			{
-				PointLaneProfileNames.Add("");
-				PointLaneCounts.Add(0);
-			}
+			NumSplineLanes += Info.SplineLaneProfile.Lanes.Num();
 		}
 		else
 		{
 			bHasPolygon = true;
+			NumPointLanes += Info.NumPointLanes;
+		}
+	}
+
+	// -------- Second pass: fill preallocated flat buffers --------
+	VertexCounts.SetNumUninitialized(NumComponents);
+	ZoneShapeTypes.SetNumUninitialized(NumComponents);
+	Positions.SetNumUninitialized(NumPoints * 3);
+	Rotations.SetNumUninitialized(NumPoints * 4);
+
+	// s@unreal_zone_lane_profile_name
+	PointLaneProfileNames.SetNumUninitialized(NumPoints);
+	SplineLaneProfileNames.SetNumUninitialized(NumComponents);
+
+	// d[]@unreal_zone_lane_profile
+	PointLanes.SetNumUninitialized(NumPointLanes);
+	PointLaneCounts.SetNumUninitialized(NumPoints);
+	SplineLanes.SetNumUninitialized(NumSplineLanes);
+	SplineLaneCounts.SetNumUninitialized(NumComponents);
+
+	// Connectors on points
+	if (NumConnectors >= 1)
+	{
+		PointConnectors.Init(INDEX_NONE, NumPoints);
+		PointConnectedPrims.Init(INDEX_NONE, NumPoints);
+		PointConnectedConnectors.Init(INDEX_NONE, NumPoints);
+		PointConnectorLaneProfileNames.Init(NAME_None, NumPoints);
+	}
 
-			// Point LaneProfiles
-			FZoneLaneProfile SplineLaneProfile;
-			SplineLaneProfile.ID = FGuid();
-			TArray<FZoneLaneProfile> LaneProfiles;
-			ZSC->GetPolygonLaneProfiles(LaneProfiles);
-			for (const FZoneShapePoint& Point : ZSC->GetPoints())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputGather);
+		ParallelFor(NumComponents, [&](int32 Idx)
 			{
-				const FZoneLaneProfile* LaneProfilePtr = nullptr;
-				if (Point.LaneProfile == FZoneShapePoint::InheritLaneProfile)
+				const int32& CompIdx = ComponentIndices[Idx];
+				const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(Components[CompIdx]);
+				const FTransform& Transform = Transforms[CompIdx];
+				const FZoneShapeGatherInfo& Info = GatherInfos[Idx];
+				const TConstArrayView<FZoneShapePoint> Points = ZSC->GetPoints();
+
+				ZoneShapeTypes[Idx] = (int32)ZSC->GetShapeType();
+				VertexCounts[Idx] = Points.Num();
+
+				if (ZSC->GetShapeType() == FZoneShapeType::Spline)
 				{
-					if (SplineLaneProfile.ID == FGuid())
-						ZSC->GetSplineLaneProfile(SplineLaneProfile);
-					LaneProfilePtr = &SplineLaneProfile;
+					// Spline LaneProfile
+					SplineLaneProfileNames[Idx] = Info.SplineLaneProfile.Name;
+					SplineLaneCounts[Idx] = Info.SplineLaneProfile.Lanes.Num();
+					FMemory::Memcpy(SplineLanes.GetData() + Info.SplineLaneOffset, Info.SplineLaneProfile.Lanes.GetData(),
+						Info.SplineLaneProfile.Lanes.Num() * sizeof(FZoneLaneDesc));
+
+					// Point LaneProfiles
+					for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+					{
+						PointLaneProfileNames[Info.PointOffset + PointIdx] = NAME_None;
+						PointLaneCounts[Info.PointOffset + PointIdx] = 0;
+					}
+				}
+				else
+				{
+					// Point LaneProfiles
+					int32 PointLaneIdx = Info.PointLaneOffset;
+					for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+					{
+						const FZoneLaneProfile* LaneProfilePtr = Info.GetPointLaneProfile(Points[PointIdx]);
+						PointLaneProfileNames[Info.PointOffset + PointIdx] = LaneProfilePtr ? LaneProfilePtr->Name : NAME_None;
+						PointLaneCounts[Info.PointOffset + PointIdx] = LaneProfilePtr ? LaneProfilePtr->Lanes.Num() : 0;
+						if (LaneProfilePtr)
+						{
+							FMemory::Memcpy(PointLanes.GetData() + PointLaneIdx, LaneProfilePtr->Lanes.GetData(),
+								LaneProfilePtr->Lanes.Num() * sizeof(FZoneLaneDesc));
+							PointLaneIdx += LaneProfilePtr->Lanes.Num();
+						}
+					}
+
+					// Spline LaneProfile
+					SplineLaneProfileNames[Idx] = NAME_None;
+					SplineLaneCounts[Idx] = 0;
 				}
-				else if (LaneProfiles.IsValidIndex(Point.LaneProfile))
-					LaneProfilePtr = &LaneProfiles[Point.LaneProfile];
-
-				PointLaneProfileNames.Add((LaneProfilePtr && !LaneProfilePtr->Name.IsNone()) ? TCHAR_TO_UTF8(*LaneProfilePtr->Name.ToString()) : "");
 
-				PointLaneCounts.Add(LaneProfilePtr ? LaneProfilePtr->Lanes.Num() : 0);
-				if (LaneProfilePtr)
+				// Connectors, ConnectedShapes are aligned with ShapeConnectors
+				const TConstArrayView<FZoneShapeConnector> Connectors = ZSC->GetShapeConnectors();
+				const TConstArrayView<FZoneShapeConnection> Connections = ZSC->GetConnectedShapes();
+				for (int32 ConnectorIdx = 0; ConnectorIdx < Connectors.Num(); ++ConnectorIdx)
 				{
-					for (const FZoneLaneDesc& Lane : LaneProfilePtr->Lanes)
-						PointLanes.Add(ConvertLaneToJsonStr(Lane, ZoneGraphSettings, LaneDictStrMap));
+					const FZoneShapeConnector& Connector = Connectors[ConnectorIdx];
+					if (!Points.IsValidIndex(Connector.PointIndex))
+						continue;
+
+					const int32 GlobalPointIdx = Info.PointOffset + Connector.PointIndex;
+					PointConnectors[GlobalPointIdx] = ConnectorIdx;
+					PointConnectorLaneProfileNames[GlobalPointIdx] = Connector.LaneProfile.Name;
+					if (Connections.IsValidIndex(ConnectorIdx))
+					{
+						const int32* FoundPrimIdxPtr = ZSCPrimIdxMap.Find(Connections[ConnectorIdx].ShapeComponent.Get());
+						if (FoundPrimIdxPtr)
+						{
+							PointConnectedPrims[GlobalPointIdx] = *FoundPrimIdxPtr;
+							PointConnectedConnectors[GlobalPointIdx] = Connections[ConnectorIdx].ConnectorIndex;
+						}
+					}
 				}
-			}
 
-			// Spline LaneProfile
-			SplineLaneProfileNames.Add("");
-			SplineLaneCounts.Add(0);
-		}
+				HoudiniMassConversion::PositionsToHoudini(Transform, Points, Positions.GetData() + Info.PointOffset * 3);
+				HoudiniMassConversion::RotationsToHoudini(Transform, Points, Rotations.GetData() + Info.PointOffset * 4);
+			});
+	}
+}
+
+void FHoudiniZoneShapesInputData::Encode(FHoudiniZoneGraphSettingsCache& SettingsCache)
+{
+	auto EncodeNamesLambda = [&SettingsCache](const TArray<FName>& Names, TArray<const char*>& OutStrs)
+		{
+			TArray<int32> EncodingIndices;
+			EncodingIndices.SetNumUninitialized(Names.Num());
+			for (int32 ElemIdx = 0; ElemIdx < Names.Num(); ++ElemIdx)
+				EncodingIndices[ElemIdx] = SettingsCache.FindOrAddNameEncoding(Names[ElemIdx]);
+
+			OutStrs.SetNumUninitialized(Names.Num());  // Get strs after all encodings added, so that they are all valid
+			for (int32 ElemIdx = 0; ElemIdx < Names.Num(); ++ElemIdx)
+				OutStrs[ElemIdx] = SettingsCache.GetNameEncoding(EncodingIndices[ElemIdx]);
+		};
 
+	auto EncodeLanesLambda = [&SettingsCache](const TArray<FZoneLaneDesc>& Lanes, TArray<const char*>& OutStrs)
+		{
+			TArray<int32> EncodingIndices;
+			EncodingIndices.SetNumUninitialized(Lanes.Num());
+			for (int32 ElemIdx = 0; ElemIdx < Lanes.Num(); ++ElemIdx)
+				EncodingIndices[ElemIdx] = SettingsCache.FindOrAddLaneEncoding(Lanes[ElemIdx]);
+
+			OutStrs.SetNumUninitialized(Lanes.Num());
+			for (int32 ElemIdx = 0; ElemIdx < Lanes.Num(); ++ElemIdx)
+				OutStrs[ElemIdx] = SettingsCache.GetLaneEncoding(EncodingIndices[ElemIdx]);
+		};
 
-		PartInfo.pointCount += NumPoints;
-		for (const FZoneShapePoint& Point : ZSC->GetPoints())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputEncode);
+		if (bHasPolygon)
+		{
+			EncodeNamesLambda(PointLaneProfileNames, PointLaneProfileNamePtrs);
+			EncodeLanesLambda(PointLanes, PointLanePtrs);
+		}
+		if (bHasSpline)
 		{
-			const FVector3f Pos = FVector3f(Transform.TransformPosition(Point.Position) * POSITION_SCALE_TO_HOUDINI);
-			Positions.Add(Pos.X);
-			Positions.Add(Pos.Z);
-			Positions.Add(Pos.Y);
-
-			const FQuat4f Rot = (FQuat4f)Transform.TransformRotation(Point.Rotation.Quaternion());
-			Rotations.Add(Rot.X);
-			Rotations.Add(Rot.Z);
-			Rotations.Add(Rot.Y);
-			Rotations.Add(-Rot.W);
+			EncodeNamesLambda(SplineLaneProfileNames, SplineLaneProfileNamePtrs);
+			EncodeLanesLambda(SplineLanes, SplineLanePtrs);
 		}
+		if (NumConnectors >= 1)
+			EncodeNamesLambda(PointConnectorLaneProfileNames, PointConnectorLaneProfileNamePtrs);
 	}
+}
+
+static bool HapiUploadZoneShapes(UHoudiniInput* Input, int32& NodeId, const UZoneGraphSettings* ZoneGraphSettings,
+	const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,
+	const TArray<int32>& ClippedFlags)  // Empty if no region, otherwise the same size as Components
+{
+	const bool bCreateNewNode = (NodeId < 0);
+	if (bCreateNewNode)
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::CreateNode(FHoudiniEngine::Get().GetSession(), Input->GetGeoNodeId(), "null",
+			TCHAR_TO_UTF8(*FString::Printf(TEXT("%s_zone_shape_%08X"), *(Components[ComponentIndices[0]]->GetOuter()->GetName()), FPlatformTime::Cycles())),
+			false, &NodeId));
+
+	FHoudiniZoneShapesInputData Data;
+	Data.Gather(Components, Transforms, ComponentIndices);
+
+	// -------- Encode lane profile names and lanes to strings, unique ones are cached across uploads --------
+	FHoudiniZoneGraphSettingsCache& SettingsCache = FHoudiniMassTranslator::Get().GetZoneGraphSettingsCache();
+	SettingsCache.Refresh(ZoneGraphSettings);
+	const int32 NumLaneEncodings = SettingsCache.GetNumLaneEncodings();
+	Data.Encode(SettingsCache);
+
+	HAPI_PartInfo PartInfo;
+	FHoudiniApi::PartInfo_Init(&PartInfo);
+	PartInfo.type = HAPI_PARTTYPE_CURVE;
+	PartInfo.faceCount = ComponentIndices.Num();
+	PartInfo.pointCount = Data.NumPoints;
 	PartInfo.vertexCount = PartInfo.pointCount;
 
-	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_UniqueLanes, SettingsCache.GetNumLaneEncodings() - NumLaneEncodings);  // Only the lanes first seen
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_InputShapes, PartInfo.faceCount);
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_InputPoints, PartInfo.pointCount);
+
+	SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputSetAttributes);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetPartInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &PartInfo));
 
 	HAPI_AttributeInfo AttributeInfo;
 	FHoudiniApi::AttributeInfo_Init(&AttributeInfo);
@@ -202,11 +365,11 @@ bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, co
 		AttributeInfo.owner = HAPI_ATTROWNER_POINT;
 		AttributeInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 			HAPI_ATTRIB_POSITION, &AttributeInfo));
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-			HAPI_ATTRIB_POSITION, &AttributeInfo, Positions.GetData(), 0, AttributeInfo.count));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_POSITION, &AttributeInfo, Data.Positions.GetData(), 0, AttributeInfo.count));
 	}
 
 	{
@@ -215,10 +378,10 @@ bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, co
 		CurveInfo.curveType = HAPI_CURVETYPE_LINEAR;
 		CurveInfo.curveCount = PartInfo.faceCount;
 		CurveInfo.vertexCount = PartInfo.vertexCount;
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetCurveInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &CurveInfo));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetCurveInfo(FHoudiniEngine::Get().GetSession(), NodeId, 0, &CurveInfo));
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetCurveCounts(
-			FHoudiniEngine::Get().GetSession(), NodeId, 0, VertexCounts.GetData(), 0, PartInfo.faceCount));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetCurveCounts(
+			FHoudiniEngine::Get().GetSession(), NodeId, 0, Data.VertexCounts.GetData(), 0, PartInfo.faceCount));
 	}
 
 	{
@@ -228,11 +391,11 @@ bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, co
 		AttributeInfo.owner = HAPI_ATTROWNER_POINT;
 		AttributeInfo.storage = HAPI_STORAGETYPE_FLOAT;
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 			HAPI_ATTRIB_ROT, &AttributeInfo));
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-			HAPI_ATTRIB_ROT, &AttributeInfo, Rotations.GetData(), 0, AttributeInfo.count));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_ROT, &AttributeInfo, Data.Rotations.GetData(), 0, AttributeInfo.count));
 	}
 
 	{
@@ -242,11 +405,11 @@ bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, co
 		AttributeInfo.owner = HAPI_ATTROWNER_PRIM;
 		AttributeInfo.storage = HAPI_STORAGETYPE_INT;
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE, &AttributeInfo));
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
-			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE, &AttributeInfo, ZoneShapeTypes.GetData(), 0, AttributeInfo.count));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE, &AttributeInfo, Data.ZoneShapeTypes.GetData(), 0, AttributeInfo.count));
 	}
 
 	static const char* SpareStr = "";
@@ -261,35 +424,250 @@ bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, co
 			// s@unreal_zone_lane_profile_name
 			AttributeInfo.storage = HAPI_STORAGETYPE_STRING;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME, &AttributeInfo));
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME, &AttributeInfo, LaneProfileNames.GetData(), 0, AttributeInfo.count));
 
 			// s@unreal_zone_lane_profile
 			AttributeInfo.storage = HAPI_STORAGETYPE_DICTIONARY_ARRAY;
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, &AttributeInfo));
 
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::SetAttributeDictionaryArrayData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeDictionaryArrayData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, &AttributeInfo,
 				(Lanes.IsEmpty() ? &SpareStr : Lanes.GetData()), Lanes.Num(), LaneCounts.GetData(), 0, AttributeInfo.count));
 
 			return true;
 		};
 
-	if (bHasPolygon)
-		HOUDINI_FAIL_RETURN(HapiSetLaneProfileLambda(PartInfo.pointCount, HAPI_ATTROWNER_POINT, PointLaneProfileNames, PointLanes, PointLaneCounts));
+	if (Data.bHasPolygon)
+		HOUDINI_FAIL_RETURN(HapiSetLaneProfileLambda(PartInfo.pointCount, HAPI_ATTROWNER_POINT, Data.PointLaneProfileNamePtrs, Data.PointLanePtrs, Data.PointLaneCounts));
+
+	if (Data.bHasSpline)
+		HOUDINI_FAIL_RETURN(HapiSetLaneProfileLambda(PartInfo.faceCount, HAPI_ATTROWNER_PRIM, Data.SplineLaneProfileNamePtrs, Data.SplineLanePtrs, Data.SplineLaneCounts));
+
+	if (Data.NumConnectors >= 1)
+	{
+		auto HapiSetPointIntLambda = [&](const char* AttribName, const TArray<int32>& Values) -> bool
+			{
+				AttributeInfo.count = PartInfo.pointCount;
+				AttributeInfo.tupleSize = 1;
+				AttributeInfo.owner = HAPI_ATTROWNER_POINT;
+				AttributeInfo.storage = HAPI_STORAGETYPE_INT;
+
+				HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					AttribName, &AttributeInfo));
+
+				HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+					AttribName, &AttributeInfo, Values.GetData(), 0, AttributeInfo.count));
+
+				return true;
+			};
+
+		// i@unreal_zone_shape_connector, i@unreal_zone_shape_connected_prim, i@unreal_zone_shape_connected_connector
+		HOUDINI_FAIL_RETURN(HapiSetPointIntLambda(HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTOR, Data.PointConnectors));
+		HOUDINI_FAIL_RETURN(HapiSetPointIntLambda(HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTED_PRIM, Data.PointConnectedPrims));
+		HOUDINI_FAIL_RETURN(HapiSetPointIntLambda(HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTED_CONNECTOR, Data.PointConnectedConnectors));
+
+		// s@unreal_zone_shape_connector_lane_profile
+		AttributeInfo.storage = HAPI_STORAGETYPE_STRING;
+
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTOR_LANE_PROFILE, &AttributeInfo));
 
-	if (bHasSpline)
-		HOUDINI_FAIL_RETURN(HapiSetLaneProfileLambda(PartInfo.faceCount, HAPI_ATTROWNER_PRIM, SplineLaneProfileNames, SplineLanes, SplineLaneCounts));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTOR_LANE_PROFILE, &AttributeInfo, Data.PointConnectorLaneProfileNamePtrs.GetData(), 0, AttributeInfo.count));
+	}
+
+	if (!ClippedFlags.IsEmpty())
+	{
+		// i@unreal_zone_shape_clipped
+		TArray<int32> bClipped;
+		bClipped.SetNumUninitialized(PartInfo.faceCount);
+		for (int32 Idx = 0; Idx < PartInfo.faceCount; ++Idx)
+			bClipped[Idx] = ClippedFlags[ComponentIndices[Idx]];
+
+		AttributeInfo.count = PartInfo.faceCount;
+		AttributeInfo.tupleSize = 1;
+		AttributeInfo.owner = HAPI_ATTROWNER_PRIM;
+		AttributeInfo.storage = HAPI_STORAGETYPE_INT;
+
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::AddAttribute(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CLIPPED, &AttributeInfo));
+
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::SetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, 0,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CLIPPED, &AttributeInfo, bClipped.GetData(), 0, AttributeInfo.count));
+	}
 
-	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::CommitGeo(FHoudiniEngine::Get().GetSession(), NodeId));
 	
 	if (bCreateNewNode)
-		HOUDINI_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+		HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(Input->HapiConnectToMergeNode(NodeId));
+
+	return true;
+}
+
+static uint64 GetZoneShapeBucketKey(const EHoudiniZoneShapeInputNodeMode& NodeMode, const float& CellSize,
+	const UZoneShapeComponent* ZSC, const FTransform& Transform)
+{
+	switch (NodeMode)
+	{
+	case EHoudiniZoneShapeInputNodeMode::PerShape: return uint64(UPTRINT(ZSC));  // Only need to be stable during this session
+	case EHoudiniZoneShapeInputNodeMode::PerCell:
+	{
+		FBox Box(ForceInit);
+		for (const FZoneShapePoint& Point : ZSC->GetPoints())
+			Box += Point.Position;
+		const FVector Center = Transform.TransformPosition(Box.IsValid ? Box.GetCenter() : FVector::ZeroVector);
+		const int32 CellX = FMath::FloorToInt32(Center.X / CellSize);
+		const int32 CellY = FMath::FloorToInt32(Center.Y / CellSize);
+		return (uint64(uint32(CellX)) << 32) | uint64(uint32(CellY));
+	}
+	}
+
+	return 0;
+}
+
+static void QueryRegionZoneShapes(const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,
+	TArray<const UActorComponent*>& OutComponents, TArray<FTransform>& OutTransforms, TArray<int32>& OutShapeIndices, TArray<int32>& OutClippedFlags)
+{
+	OutComponents = Components;
+	OutTransforms = Transforms;
+
+	TArray<const UHoudiniZoneShapeRegionComponent*> Regions;
+	TArray<int32> RegionIndices;
+	for (const int32& CompIdx : ComponentIndices)
+	{
+		if (const UHoudiniZoneShapeRegionComponent* Region = Cast<UHoudiniZoneShapeRegionComponent>(Components[CompIdx]))
+		{
+			Regions.Add(Region);
+			RegionIndices.Add(CompIdx);
+		}
+		else
+			OutShapeIndices.Add(CompIdx);
+	}
+
+	if (Regions.IsEmpty())
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputRegionQuery);
+
+	OutClippedFlags.SetNumZeroed(Components.Num());
+	TMap<const UActorComponent*, int32> ComponentIdxMap;  // Picked shapes should NOT be duplicated
+	for (const int32& CompIdx : OutShapeIndices)
+		ComponentIdxMap.Add(Components[CompIdx], CompIdx);
+
+	FHoudiniZoneShapeSpatialIndex& SpatialIndex = FHoudiniMassTranslator::Get().GetZoneShapeSpatialIndex();
+	TArray<const UZoneShapeComponent*> FoundZSCs;
+	for (int32 RegionIdx = 0; RegionIdx < Regions.Num(); ++RegionIdx)
+	{
+		const UHoudiniZoneShapeRegionComponent* Region = Regions[RegionIdx];
+		const FTransform& RegionTransform = Region->GetComponentTransform();
+		const FTransform RegionToInput = RegionTransform.Inverse() * Transforms[RegionIndices[RegionIdx]];  // World -> the space of input transforms
+		const FBox LocalBox = FBox::BuildAABB(FVector::ZeroVector, Region->GetUnscaledBoxExtent());
+
+		FoundZSCs.Reset();
+		SpatialIndex.Query(Region->GetWorld(), LocalBox.TransformBy(RegionTransform), FoundZSCs);
+		for (const UZoneShapeComponent* ZSC : FoundZSCs)
+		{
+			// Intersect and clip by the oriented box, with the same padded bounds as spatial index, so that curves and lanes bulging out are clipped
+			const FTransform ShapeToRegion = ZSC->GetComponentTransform().GetRelativeTransform(RegionTransform);
+			const FBox ShapeBox = FHoudiniZoneShapeSpatialIndex::GetBounds(ZSC, ShapeToRegion);
+			if (!ShapeBox.IsValid || !ShapeBox.Intersect(LocalBox))
+				continue;
+
+			const bool bClipped = !LocalBox.IsInsideOrOn(ShapeBox.Min) || !LocalBox.IsInsideOrOn(ShapeBox.Max);
+
+			if (const int32* FoundCompIdxPtr = ComponentIdxMap.Find(ZSC))  // Picked or found by another region, inside any region means NOT clipped
+			{
+				if (!bClipped)
+					OutClippedFlags[*FoundCompIdxPtr] = 0;
+				continue;
+			}
+
+			const int32 NewCompIdx = OutComponents.Add(ZSC);
+			OutTransforms.Add(ZSC->GetComponentTransform() * RegionToInput);
+			OutClippedFlags.Add(bClipped ? 1 : 0);
+			OutShapeIndices.Add(NewCompIdx);
+			ComponentIdxMap.Add(ZSC, NewCompIdx);
+		}
+	}
+}
+
+bool FHoudiniZoneShapeComponentInputBuilder::HapiUpload(UHoudiniInput* Input, const bool& bIsSingleComponent,  // Is there only one single valid component in the whole blueprint/actor
+	const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices,  // Components and Transforms are all of the components in blueprint/actor, and ComponentIndices are ref the valid indices from IsValidInput
+	int32& InOutInstancerNodeId, TArray<TSharedPtr<FHoudiniComponentInput>>& InOutComponentInputs, TArray<FHoudiniComponentInputPoint>& InOutPoints)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniInputZoneShape);
+
+	TSharedPtr<FHoudiniZoneShapeComponentInput> ZSCInput;
+	if (InOutComponentInputs.IsValidIndex(0))
+		ZSCInput = StaticCastSharedPtr<FHoudiniZoneShapeComponentInput>(InOutComponentInputs[0]);
+	else
+	{
+		ZSCInput = MakeShared<FHoudiniZoneShapeComponentInput>();
+		InOutComponentInputs.Add(ZSCInput);
+	}
+
+	const UZoneGraphSettings* ZoneGraphSettings = GetDefault<UZoneGraphSettings>();
+	const UHoudiniMassSettings* Settings = GetDefault<UHoudiniMassSettings>();
+	const EHoudiniZoneShapeInputNodeMode NodeMode = Settings->ZoneShapeInputNodeMode;
+	const float CellSize = FMath::Max(Settings->ZoneShapeInputCellSize, 100.0f);
+
+	// -------- Append the zone shapes in world that intersect regions, their transforms are relative to the region like the picked ones --------
+	TArray<const UActorComponent*> AllComponents;
+	TArray<FTransform> AllTransforms;
+	TArray<int32> ShapeIndices;  // Ref AllComponents
+	TArray<int32> ClippedFlags;  // Empty if no region
+	QueryRegionZoneShapes(Components, Transforms, ComponentIndices, AllComponents, AllTransforms, ShapeIndices, ClippedFlags);
+
+	// -------- Classify components into buckets, and hash them --------
+	TMap<uint64, TPair<TArray<int32>, TArray<uint32>>> NewBuckets;  // Key: Bucket key, Value: Component indices and hashes
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_InputClassify);
+		for (const int32& CompIdx : ShapeIndices)
+		{
+			const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(AllComponents[CompIdx]);
+			TPair<TArray<int32>, TArray<uint32>>& NewBucket = NewBuckets.FindOrAdd(
+				GetZoneShapeBucketKey(NodeMode, CellSize, ZSC, AllTransforms[CompIdx]));
+			NewBucket.Key.Add(CompIdx);
+			NewBucket.Value.Add(ClippedFlags.IsEmpty() ? GetZoneShapeComponentHash(ZSC, AllTransforms[CompIdx]) :
+				HashCombineFast(GetZoneShapeComponentHash(ZSC, AllTransforms[CompIdx]), GetTypeHash(ClippedFlags[CompIdx])));
+		}
+	}
+
+	// -------- Destroy the nodes of buckets that no longer exist --------
+	for (TMap<uint64, FHoudiniZoneShapeInputBucket>::TIterator BucketIter(ZSCInput->Buckets); BucketIter; ++BucketIter)
+	{
+		if (NewBuckets.Contains(BucketIter->Key))
+			continue;
+
+		if (BucketIter->Value.NodeId >= 0)
+		{
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::DeleteNode(FHoudiniEngine::Get().GetSession(), BucketIter->Value.NodeId));
+			Input->NotifyMergedNodeDestroyed();
+		}
+		BucketIter.RemoveCurrent();
+	}
+
+	// -------- Only upload the buckets that have changed since the last upload --------
+	const uint32 SettingsHash = GetZoneGraphSettingsHash(ZoneGraphSettings);
+	const bool bSettingsChanged = (ZSCInput->SettingsHash != SettingsHash);
+	for (auto& NewBucket : NewBuckets)
+	{
+		FHoudiniZoneShapeInputBucket& Bucket = ZSCInput->Buckets.FindOrAdd(NewBucket.Key);
+		if (!bSettingsChanged && (Bucket.NodeId >= 0) && (Bucket.ComponentHashes == NewBucket.Value.Value))
+			continue;
+
+		Bucket.ComponentHashes.Empty();  // Mark dirty until the upload succeeded
+		HOUDINI_FAIL_RETURN(HapiUploadZoneShapes(Input, Bucket.NodeId, ZoneGraphSettings, AllComponents, AllTransforms, NewBucket.Value.Key, ClippedFlags));
+		Bucket.ComponentHashes = MoveTemp(NewBucket.Value.Value);
+	}
+
+	ZSCInput->SettingsHash = SettingsHash;
 
 	return true;
 }
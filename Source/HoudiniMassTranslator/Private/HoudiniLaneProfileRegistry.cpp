@@ -0,0 +1,131 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniLaneProfileRegistry.h"
+
+#include "GameFramework/Actor.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+
+FString UHoudiniLaneProfileRegistry::GetOwnerKey(const AActor* Node, const UObject* Output)
+{
+	if (Node && Node->GetActorGuid().IsValid())
+		return Node->GetActorGuid().ToString() + TEXT("|") + Output->GetName();
+
+	return Output->GetPathName();
+}
+
+void UHoudiniLaneProfileRegistry::Load()
+{
+	if (bLoaded)
+		return;
+
+	OwnerMap.Empty(Owners.Num());
+	RefCounts.Empty();
+	for (const FHoudiniLaneProfileOwner& Owner : Owners)
+	{
+		OwnerMap.Add(Owner.Key, Owner);
+		AddRefCounts(Owner.References, 1);
+	}
+	bLoaded = true;
+}
+
+void UHoudiniLaneProfileRegistry::AddRefCounts(const TArray<FHoudiniLaneProfileReferences>& References, const int32& Delta)
+{
+	for (const FHoudiniLaneProfileReferences& Refs : References)
+	{
+		for (const FGuid& LaneProfileID : Refs.LaneProfileIDs)
+		{
+			int32& RefCount = RefCounts.FindOrAdd(LaneProfileID, 0);
+			RefCount += Delta;
+			if (RefCount <= 0)
+				RefCounts.Remove(LaneProfileID);
+		}
+	}
+}
+
+void UHoudiniLaneProfileRegistry::SetReferences(const AActor* Node, const UObject* Output, const TArray<FHoudiniLaneProfileReferences>& References)
+{
+	if (References.IsEmpty())
+	{
+		RemoveReferences(Node, Output);
+		return;
+	}
+
+	Load();
+
+	const FString OwnerKey = GetOwnerKey(Node, Output);
+	const FString PackageName = Output->GetPackage()->GetName();
+	if (FHoudiniLaneProfileOwner* FoundOwner = OwnerMap.Find(OwnerKey))
+	{
+		if ((FoundOwner->PackageName == PackageName) && (FoundOwner->References == References))
+			return;
+
+		AddRefCounts(FoundOwner->References, -1);
+		FoundOwner->PackageName = PackageName;
+		FoundOwner->References = References;
+	}
+	else
+		OwnerMap.Add(OwnerKey, FHoudiniLaneProfileOwner{ OwnerKey, PackageName, References });
+
+	AddRefCounts(References, 1);
+	bModified = true;
+}
+
+void UHoudiniLaneProfileRegistry::RemoveReferences(const AActor* Node, const UObject* Output)
+{
+	Load();
+
+	FHoudiniLaneProfileOwner RemovedOwner;
+	if (OwnerMap.RemoveAndCopyValue(GetOwnerKey(Node, Output), RemovedOwner))
+	{
+		AddRefCounts(RemovedOwner.References, -1);
+		bModified = true;
+	}
+}
+
+void UHoudiniLaneProfileRegistry::Prune()
+{
+	Load();
+
+	for (TMap<FString, FHoudiniLaneProfileOwner>::TIterator OwnerIter(OwnerMap); OwnerIter; ++OwnerIter)
+	{
+		const FString& PackageName = OwnerIter->Value.PackageName;
+		if (FindPackage(nullptr, *PackageName) || FPackageName::DoesPackageExist(PackageName))  // Unsaved packages are only in memory
+			continue;
+
+		AddRefCounts(OwnerIter->Value.References, -1);
+		OwnerIter.RemoveCurrent();
+		bModified = true;
+	}
+}
+
+bool UHoudiniLaneProfileRegistry::IsReferenced(const FGuid& LaneProfileID)
+{
+	Load();
+
+	return RefCounts.Contains(LaneProfileID);
+}
+
+void UHoudiniLaneProfileRegistry::Empty()
+{
+	Load();
+
+	if (OwnerMap.IsEmpty())
+		return;
+
+	OwnerMap.Empty();
+	RefCounts.Empty();
+	bModified = true;
+}
+
+void UHoudiniLaneProfileRegistry::SaveIfModified()
+{
+	if (!bModified)
+		return;
+
+	OwnerMap.KeySort([](const FString& A, const FString& B) { return A < B; });  // Stable order, so that config diffs only show the changed owners
+	OwnerMap.GenerateValueArray(Owners);
+	TryUpdateDefaultConfigFile();
+	bModified = false;
+}
@@ -0,0 +1,816 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "ZoneGraphSettings.h"
+#include "ZoneShapeComponent.h"
+
+#include "HoudiniEngine.h"
+#include "HoudiniNode.h"
+
+#include "HoudiniInputZoneShape.h"
+#include "HoudiniLaneProfileRegistry.h"
+#include "HoudiniMassConversion.h"
+#include "HoudiniOutputZoneShape.h"
+#include "HoudiniZoneGraphSettingsCache.h"
+
+
+// Synthetic road networks run through the stages of zone shape input and output that do NOT need a houdini session,
+// so that we could compare numbers before and after plugin updates, on machines without houdini licenses, e.g.
+// UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="HoudiniMass.Benchmark Shapes=10000 Points=16 Lanes=64 Tags=8, Quit"
+// Lane profiles are transient and NOT added to UZoneGraphSettings, so UpdateShape builds the shapes without lanes
+namespace HoudiniMassBenchmark
+{
+	struct FParams
+	{
+		int32 NumShapes = 1000;
+		int32 NumPoints = 8;  // Per shape
+		int32 NumLaneProfiles = 16;
+		int32 NumTags = 4;
+		int32 NumIterations = 3;
+	};
+
+	static FString FormatRate(const int32& Count, const double& Seconds)
+	{
+		return FString::Printf(TEXT("%.3f ms, %.0f/s"), Seconds * 1000.0, (Seconds > 0.0) ? (Count / Seconds) : 0.0);
+	}
+
+	static double GetPeakUsedMB()
+	{
+		return double(FPlatformMemory::GetStats().PeakUsedPhysical) / (1024.0 * 1024.0);
+	}
+
+	// Outputs create components on their node actor, so we spawn one in a transient world, it will never cook
+	struct FOutputEnvironment
+	{
+		UWorld* World = nullptr;
+		AHoudiniNode* Node = nullptr;
+		UHoudiniOutputZoneShape* Output = nullptr;
+
+		FOutputEnvironment();
+
+		~FOutputEnvironment();
+
+		// Drive the same task as HapiUpdate, returns the task to read stage times from
+		TSharedPtr<FHoudiniZoneShapeOutputTask> RunOutput(TArray<FHoudiniZoneShapePart>&& Parts, const TArray<FZoneLaneProfile>& LaneProfiles) const;
+	};
+
+	static void LogOutputTimes(const FHoudiniZoneShapeOutputTask& Task, const int32& NumShapes, const int32& NumPoints);
+
+	static void GenerateLaneProfiles(const FParams& Params, TArray<FZoneLaneProfile>& OutLaneProfiles);
+
+	static void GenerateShapes(const FParams& Params, const TArray<FZoneLaneProfile>& LaneProfiles, TArray<UZoneShapeComponent*>& OutZSCs);
+
+	// Decode the gathered data back to a part, as if houdini passes it through. Lane profiles, tags and point types are NOT gathered by input,
+	// so they are taken from the components, lane profiles are matched by ID, as the transient ones could NOT be found by name in UZoneGraphSettings
+	static FHoudiniZoneShapePart MakePart(FHoudiniZoneShapesInputData& Data, const TArray<UZoneShapeComponent*>& ZSCs, const TArray<FZoneLaneProfile>& LaneProfiles);
+
+	static void Run(const FParams& Params);
+
+	static void Replay(const FString& FilePath, const int32& NumIterations);
+
+	static void GenerateConversionPoints(const int32& NumPoints, TArray<FZoneShapePoint>& OutPoints);
+
+	static const FTransform ConversionTransform(FRotator(10.0, 30.0, 5.0), FVector(1000.0, -2000.0, 300.0), FVector(1.5, 1.5, 1.0));
+
+	// The scalar loops that HoudiniMassConversion kernels replaced, as the reference of kernel results
+	static void ScalarToHoudini(const FTransform& Transform, const TArray<FZoneShapePoint>& Points, TArray<float>& OutPositions, TArray<float>& OutRotations);
+
+	static void ScalarToUnreal(const TArray<float>& Positions, const TArray<float>& Rotations, TArray<FZoneShapePoint>& OutPoints, TArray<FRotator>& OutRots);
+
+	// Compare HoudiniMassConversion kernels with the scalar loops they replaced, on random points
+	static void RunConversion(const int32& NumPoints, const int32& NumIterations);
+}
+
+HoudiniMassBenchmark::FOutputEnvironment::FOutputEnvironment()
+{
+	World = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("HoudiniMassBenchmark"));
+	Node = World->SpawnActor<AHoudiniNode>();
+	Output = NewObject<UHoudiniOutputZoneShape>(Node, NAME_None, RF_Transient);
+}
+
+HoudiniMassBenchmark::FOutputEnvironment::~FOutputEnvironment()
+{
+	FHoudiniZoneShapeOutputTask::Create(Output, TArray<FHoudiniZoneShapePart>())->Process(DBL_MAX);  // Destroy components, and remove them from spatial index
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+TSharedPtr<FHoudiniZoneShapeOutputTask> HoudiniMassBenchmark::FOutputEnvironment::RunOutput(TArray<FHoudiniZoneShapePart>&& Parts, const TArray<FZoneLaneProfile>& LaneProfiles) const
+{
+	TSharedPtr<FHoudiniZoneShapeOutputTask> Task = FHoudiniZoneShapeOutputTask::Create(Output, MoveTemp(Parts), &LaneProfiles);
+	Task->Process(DBL_MAX);
+	return Task;
+}
+
+void HoudiniMassBenchmark::LogOutputTimes(const FHoudiniZoneShapeOutputTask& Task, const int32& NumShapes, const int32& NumPoints)
+{
+	using EStage = FHoudiniZoneShapeOutputTask::EStage;
+	const double& BuildPointsTime = Task.GetStageSeconds(EStage::BuildPoints);
+	const double& ApplyTime = Task.GetStageSeconds(EStage::Apply);
+	const double& DestroyOldTime = Task.GetStageSeconds(EStage::DestroyOld);
+	const double& UpdateShapeTime = Task.GetStageSeconds(EStage::UpdateShape);
+	UE_LOG(LogHoudiniEngine, Display, TEXT("    Output Build Points: shapes %s, points %s"), *FormatRate(NumShapes, BuildPointsTime), *FormatRate(NumPoints, BuildPointsTime));
+	UE_LOG(LogHoudiniEngine, Display, TEXT("    Output Apply:        shapes %s, points %s"), *FormatRate(NumShapes, ApplyTime), *FormatRate(NumPoints, ApplyTime));
+	UE_LOG(LogHoudiniEngine, Display, TEXT("    Output Destroy Old:  %.3f ms"), DestroyOldTime * 1000.0);
+	UE_LOG(LogHoudiniEngine, Display, TEXT("    Output UpdateShape:  shapes %s, points %s"), *FormatRate(NumShapes, UpdateShapeTime), *FormatRate(NumPoints, UpdateShapeTime));
+}
+
+void HoudiniMassBenchmark::GenerateLaneProfiles(const FParams& Params, TArray<FZoneLaneProfile>& OutLaneProfiles)
+{
+	for (int32 LaneProfileIdx = 0; LaneProfileIdx < Params.NumLaneProfiles; ++LaneProfileIdx)
+	{
+		FZoneLaneProfile& LaneProfile = OutLaneProfiles.AddDefaulted_GetRef();
+		LaneProfile.Name = *FString::Printf(TEXT("LP_HE_Benchmark_%d"), LaneProfileIdx);
+		LaneProfile.ID = FGuid::NewGuid();
+		const int32 NumLanes = 1 + LaneProfileIdx % 4;
+		for (int32 LaneIdx = 0; LaneIdx < NumLanes; ++LaneIdx)
+		{
+			FZoneLaneDesc& Lane = LaneProfile.Lanes.AddDefaulted_GetRef();
+			Lane.Width = 300.0f + 25.0f * ((LaneProfileIdx + LaneIdx) % 8);
+			Lane.Direction = (LaneIdx % 2) ? EZoneLaneDirection::Backward : EZoneLaneDirection::Forward;
+			Lane.Tags = (Params.NumTags >= 1) ? FZoneGraphTagMask(1u << ((LaneProfileIdx + LaneIdx) % Params.NumTags)) : FZoneGraphTagMask::None;
+		}
+	}
+}
+
+void HoudiniMassBenchmark::GenerateShapes(const FParams& Params, const TArray<FZoneLaneProfile>& LaneProfiles, TArray<UZoneShapeComponent*>& OutZSCs)
+{
+	auto GetShapeLaneProfileIdxLambda = [&](const int32& ShapeIdx, const int32& PointIdx) -> int32
+		{
+			return LaneProfiles.IsEmpty() ? INDEX_NONE : ((ShapeIdx + PointIdx) % LaneProfiles.Num());
+		};
+
+	// Every 4th shape is a polygon
+	for (int32 ShapeIdx = 0; ShapeIdx < Params.NumShapes; ++ShapeIdx)
+	{
+		UZoneShapeComponent* ZSC = NewObject<UZoneShapeComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+		const bool bIsPolygon = (ShapeIdx % 4 == 3);
+		ZSC->SetShapeType(bIsPolygon ? FZoneShapeType::Polygon : FZoneShapeType::Spline);
+		ZSC->SetTags((Params.NumTags >= 1) ? FZoneGraphTagMask(1u << (ShapeIdx % Params.NumTags)) : FZoneGraphTagMask::None);
+
+		const int32 SplineLaneProfileIdx = GetShapeLaneProfileIdxLambda(ShapeIdx, 0);
+		if (SplineLaneProfileIdx >= 0)
+			ZSC->SetCommonLaneProfile(LaneProfiles[SplineLaneProfileIdx]);
+
+		const FVector Center((ShapeIdx % 100) * 10000.0, (ShapeIdx / 100) * 10000.0, 0.0);
+		TArray<FZoneShapePoint>& Points = ZSC->GetMutablePoints();
+		Points.SetNum(Params.NumPoints);
+		for (int32 PointIdx = 0; PointIdx < Params.NumPoints; ++PointIdx)
+		{
+			FZoneShapePoint& Point = Points[PointIdx];
+			if (bIsPolygon)
+			{
+				const double Angle = UE_DOUBLE_TWO_PI * PointIdx / Params.NumPoints;
+				Point.Position = Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0) * 2000.0;
+				Point.Rotation = FRotator(0.0, FMath::RadiansToDegrees(Angle) + 180.0, 0.0);
+				Point.Type = FZoneShapePointType::LaneProfile;
+				const int32 LaneProfileIdx = GetShapeLaneProfileIdxLambda(ShapeIdx, PointIdx);
+				if (LaneProfileIdx >= 0)
+					Point.LaneProfile = ZSC->AddUniquePerPointLaneProfile(LaneProfiles[LaneProfileIdx]);
+			}
+			else
+			{
+				Point.Position = Center + FVector(PointIdx * 1000.0, FMath::Sin(PointIdx * 0.5) * 500.0, 0.0);
+				Point.Type = FZoneShapePointType::AutoBezier;
+			}
+		}
+
+		OutZSCs.Add(ZSC);
+	}
+}
+
+FHoudiniZoneShapePart HoudiniMassBenchmark::MakePart(FHoudiniZoneShapesInputData& Data, const TArray<UZoneShapeComponent*>& ZSCs, const TArray<FZoneLaneProfile>& LaneProfiles)
+{
+	const int32 NumShapes = ZSCs.Num();
+
+	HAPI_PartInfo PartInfo;
+	FMemory::Memzero(PartInfo);  // Do NOT use FHoudiniApi::PartInfo_Init, as HAPI may not be loaded
+	PartInfo.type = HAPI_PARTTYPE_CURVE;
+	PartInfo.faceCount = NumShapes;
+	PartInfo.pointCount = Data.NumPoints;
+	PartInfo.vertexCount = Data.NumPoints;
+
+	FHoudiniZoneShapePart Part(PartInfo);
+	TArray<int32>& CurveIndices = Part.SplitCurvesMap.Add(0, FHoudiniZoneShapeCurves(HAPI_PARTIAL_OUTPUT_MODE_REPLACE, FString())).CurveIndices;
+	CurveIndices.SetNumUninitialized(NumShapes);
+	Part.VertexIndices.SetNumUninitialized(NumShapes);
+	int32 NumVertices = 0;
+	for (int32 ShapeIdx = 0; ShapeIdx < NumShapes; ++ShapeIdx)
+	{
+		CurveIndices[ShapeIdx] = ShapeIdx;
+		NumVertices += Data.VertexCounts[ShapeIdx];
+		Part.VertexIndices[ShapeIdx] = NumVertices;
+	}
+
+	Part.PositionData = MoveTemp(Data.Positions);
+
+	Part.RotOwner = HAPI_ATTROWNER_POINT;
+	Part.Rots.SetNumUninitialized(Data.NumPoints);
+	for (int32 PointIdx = 0; PointIdx < Data.NumPoints; ++PointIdx)
+	{
+		const float* RotationPtr = Data.Rotations.GetData() + PointIdx * 4;
+		Part.Rots[PointIdx] = FQuat(RotationPtr[0], RotationPtr[2], RotationPtr[1], -RotationPtr[3]).Rotator();
+	}
+
+	TMap<FGuid, int32> IDLaneProfileIdxMap;
+	for (int32 LaneProfileIdx = 0; LaneProfileIdx < LaneProfiles.Num(); ++LaneProfileIdx)
+		IDLaneProfileIdxMap.Add(LaneProfiles[LaneProfileIdx].ID, LaneProfileIdx);
+
+	auto FindLaneProfileIdxLambda = [&IDLaneProfileIdxMap](const FZoneLaneProfileRef& LaneProfileRef) -> int32
+		{
+			const int32* FoundLaneProfileIdxPtr = IDLaneProfileIdxMap.Find(LaneProfileRef.ID);
+			return FoundLaneProfileIdxPtr ? *FoundLaneProfileIdxPtr : INDEX_NONE;
+		};
+
+	FHoudiniZoneShapePointPropertySetter& TypeSetter = Part.PointPropSetters.AddDefaulted_GetRef();  // As unreal_uproperty_Type
+	TypeSetter.Init(GET_MEMBER_NAME_CHECKED(FZoneShapePoint, Type));
+	TypeSetter.Owner = HAPI_ATTROWNER_POINT;
+	TypeSetter.Data.SetNumUninitialized(Data.NumPoints);
+
+	Part.ZoneShapeTypeOwner = HAPI_ATTROWNER_PRIM;
+	Part.LaneProfileOwner = HAPI_ATTROWNER_PRIM;
+	Part.ZoneGraphTagOwner = HAPI_ATTROWNER_PRIM;
+	Part.PointLaneProfileIndices.SetNumUninitialized(Data.NumPoints);
+	for (int32 ShapeIdx = 0; ShapeIdx < NumShapes; ++ShapeIdx)
+	{
+		const UZoneShapeComponent* ZSC = ZSCs[ShapeIdx];
+		Part.ZoneShapeTypes.Add(int8(Data.ZoneShapeTypes[ShapeIdx]));
+		Part.LaneProfileIndices.Add(FindLaneProfileIdxLambda(ZSC->GetCommonLaneProfile()));
+		Part.ZoneGraphTags.Add(ZSC->GetTags());
+
+		const int32 StartVertexIdx = (ShapeIdx == 0) ? 0 : Part.VertexIndices[ShapeIdx - 1];
+		const TConstArrayView<FZoneShapePoint> Points = ZSC->GetPoints();
+		for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+		{
+			const FZoneShapePoint& Point = Points[PointIdx];
+			TypeSetter.Data[StartVertexIdx + PointIdx] = float(uint8(Point.Type));
+			Part.PointLaneProfileIndices[StartVertexIdx + PointIdx] = ZSC->GetPerPointLaneProfiles().IsValidIndex(Point.LaneProfile) ?
+				FindLaneProfileIdxLambda(ZSC->GetPerPointLaneProfiles()[Point.LaneProfile]) : INDEX_NONE;
+		}
+	}
+
+	return Part;
+}
+
+void HoudiniMassBenchmark::Run(const FParams& Params)
+{
+	TArray<FZoneLaneProfile> LaneProfiles;
+	GenerateLaneProfiles(Params, LaneProfiles);
+
+	TArray<UZoneShapeComponent*> InputZSCs;
+	GenerateShapes(Params, LaneProfiles, InputZSCs);
+
+	TArray<const UActorComponent*> Components;
+	TArray<FTransform> Transforms;
+	TArray<int32> ComponentIndices;
+	for (int32 ShapeIdx = 0; ShapeIdx < InputZSCs.Num(); ++ShapeIdx)
+	{
+		Components.Add(InputZSCs[ShapeIdx]);
+		Transforms.Add(FTransform::Identity);
+		ComponentIndices.Add(ShapeIdx);
+	}
+
+	const int32 NumTotalPoints = Params.NumShapes * Params.NumPoints;
+	UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.Benchmark: %d shapes, %d points, %d lane profiles, %d tags, %d iterations"),
+		Params.NumShapes, NumTotalPoints, Params.NumLaneProfiles, Params.NumTags, Params.NumIterations);
+
+	{
+		FOutputEnvironment Environment;
+		for (int32 Iteration = 0; Iteration < Params.NumIterations; ++Iteration)
+		{
+			// -------- Input: gather and encode, as the same as HapiUpload without HAPI calls --------
+			FHoudiniZoneGraphSettingsCache SettingsCache;  // Do NOT use the one in module, so that every iteration starts cold
+			FHoudiniZoneShapesInputData Data;
+
+			double StartTime = FPlatformTime::Seconds();
+			Data.Gather(Components, Transforms, ComponentIndices);
+			const double GatherTime = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			SettingsCache.Refresh(GetDefault<UZoneGraphSettings>());  // Only tag names are used
+			Data.Encode(SettingsCache);
+			const double EncodeTime = FPlatformTime::Seconds() - StartTime;
+
+			// -------- Output: the previous iteration's components will be destroyed --------
+			TArray<FHoudiniZoneShapePart> Parts;
+			Parts.Add(MakePart(Data, InputZSCs, LaneProfiles));
+			const TSharedPtr<FHoudiniZoneShapeOutputTask> Task = Environment.RunOutput(MoveTemp(Parts), LaneProfiles);
+
+			UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.Benchmark: iteration %d"), Iteration);
+			UE_LOG(LogHoudiniEngine, Display, TEXT("    Input Gather:        shapes %s, points %s"), *FormatRate(Params.NumShapes, GatherTime), *FormatRate(NumTotalPoints, GatherTime));
+			UE_LOG(LogHoudiniEngine, Display, TEXT("    Input Encode:        shapes %s, points %s, %d unique lanes"), *FormatRate(Params.NumShapes, EncodeTime), *FormatRate(NumTotalPoints, EncodeTime), SettingsCache.GetNumLaneEncodings());
+			LogOutputTimes(*Task, Params.NumShapes, NumTotalPoints);
+			UE_LOG(LogHoudiniEngine, Display, TEXT("    Peak Used Physical:  %.1f MB"), GetPeakUsedMB());
+		}
+	}
+
+	// -------- Clean up --------
+	for (UZoneShapeComponent* ZSC : InputZSCs)
+		ZSC->MarkAsGarbage();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void HoudiniMassBenchmark::Replay(const FString& FilePath, const int32& NumIterations)
+{
+	FHoudiniZoneShapeCapture Capture;
+	if (!Capture.Load(FilePath))
+	{
+		UE_LOG(LogHoudiniEngine, Error, TEXT("HoudiniMass.ReplayZoneShapeOutput: failed to load %s"), *FilePath);
+		return;
+	}
+
+	int32 NumShapes = 0;
+	int32 NumPoints = 0;
+	for (const FHoudiniZoneShapePart& Part : Capture.Parts)
+	{
+		for (const auto& SplitCurves : Part.SplitCurvesMap)
+		{
+			for (const int32& CurveIdx : SplitCurves.Value.CurveIndices)
+				NumPoints += Part.VertexIndices[CurveIdx] - ((CurveIdx == 0) ? 0 : Part.VertexIndices[CurveIdx - 1]);
+			NumShapes += SplitCurves.Value.CurveIndices.Num();
+		}
+	}
+
+	UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.ReplayZoneShapeOutput: %s, %d parts, %d lane profiles, %d iterations"),
+		*FilePath, Capture.Parts.Num(), Capture.LaneProfiles.Num(), NumIterations);
+
+	{
+		FOutputEnvironment Environment;
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			TArray<FHoudiniZoneShapePart> Parts = Capture.Parts;  // Task will consume them
+			const TSharedPtr<FHoudiniZoneShapeOutputTask> Task = Environment.RunOutput(MoveTemp(Parts), Capture.LaneProfiles);
+
+			UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.ReplayZoneShapeOutput: iteration %d"), Iteration);
+			LogOutputTimes(*Task, NumShapes, NumPoints);
+			UE_LOG(LogHoudiniEngine, Display, TEXT("    Peak Used Physical:  %.1f MB"), GetPeakUsedMB());
+		}
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void HoudiniMassBenchmark::GenerateConversionPoints(const int32& NumPoints, TArray<FZoneShapePoint>& OutPoints)
+{
+	FRandomStream Random(NumPoints);
+	OutPoints.SetNum(NumPoints);
+	for (FZoneShapePoint& Point : OutPoints)
+	{
+		Point.Position = Random.GetUnitVector() * Random.FRandRange(0.0, 100000.0);
+		Point.Rotation = FRotator(Random.FRandRange(-89.0, 89.0), Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0));
+	}
+}
+
+void HoudiniMassBenchmark::ScalarToHoudini(const FTransform& Transform, const TArray<FZoneShapePoint>& Points, TArray<float>& OutPositions, TArray<float>& OutRotations)
+{
+	const int32 NumPoints = Points.Num();
+	OutPositions.SetNumUninitialized(NumPoints * 3);
+	OutRotations.SetNumUninitialized(NumPoints * 4);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const FVector3f Pos = FVector3f(Transform.TransformPosition(Points[PointIdx].Position) * POSITION_SCALE_TO_HOUDINI);
+		OutPositions[PointIdx * 3] = Pos.X;
+		OutPositions[PointIdx * 3 + 1] = Pos.Z;
+		OutPositions[PointIdx * 3 + 2] = Pos.Y;
+
+		const FQuat4f Rot = (FQuat4f)Transform.TransformRotation(Points[PointIdx].Rotation.Quaternion());
+		OutRotations[PointIdx * 4] = Rot.X;
+		OutRotations[PointIdx * 4 + 1] = Rot.Z;
+		OutRotations[PointIdx * 4 + 2] = Rot.Y;
+		OutRotations[PointIdx * 4 + 3] = -Rot.W;
+	}
+}
+
+void HoudiniMassBenchmark::ScalarToUnreal(const TArray<float>& Positions, const TArray<float>& Rotations, TArray<FZoneShapePoint>& OutPoints, TArray<FRotator>& OutRots)
+{
+	const int32 NumPoints = Positions.Num() / 3;
+	OutPoints.SetNum(NumPoints);
+	OutRots.SetNumUninitialized(NumPoints);
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		OutPoints[PointIdx].Position = FVector(Positions[PointIdx * 3], Positions[PointIdx * 3 + 2], Positions[PointIdx * 3 + 1]) * POSITION_SCALE_TO_UNREAL;
+		OutRots[PointIdx] = FQuat(Rotations[PointIdx * 4], Rotations[PointIdx * 4 + 2], Rotations[PointIdx * 4 + 1], -Rotations[PointIdx * 4 + 3]).Rotator();
+	}
+}
+
+void HoudiniMassBenchmark::RunConversion(const int32& NumPoints, const int32& NumIterations)
+{
+	TArray<FZoneShapePoint> Points;
+	GenerateConversionPoints(NumPoints, Points);
+	const FTransform& Transform = ConversionTransform;
+
+	TArray<float> ScalarPositions, ScalarRotations, Positions, Rotations;
+	Positions.SetNumUninitialized(NumPoints * 3);
+	Rotations.SetNumUninitialized(NumPoints * 4);
+	TArray<FZoneShapePoint> ScalarOutPoints, OutPoints;
+	OutPoints.SetNum(NumPoints);
+	TArray<FRotator> ScalarRots, Rots;
+	Rots.SetNumUninitialized(NumPoints);
+
+	UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.BenchmarkConversion: %d points, %d iterations"), NumPoints, NumIterations);
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		// -------- To houdini --------
+		double StartTime = FPlatformTime::Seconds();
+		ScalarToHoudini(Transform, Points, ScalarPositions, ScalarRotations);
+		const double ScalarToHoudiniTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		HoudiniMassConversion::PositionsToHoudini(Transform, Points, Positions.GetData());
+		HoudiniMassConversion::RotationsToHoudini(Transform, Points, Rotations.GetData());
+		const double ToHoudiniTime = FPlatformTime::Seconds() - StartTime;
+
+		// -------- To unreal --------
+		StartTime = FPlatformTime::Seconds();
+		ScalarToUnreal(Positions, Rotations, ScalarOutPoints, ScalarRots);
+		const double ScalarToUnrealTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		HoudiniMassConversion::PositionsToUnreal(Positions.GetData(), OutPoints);
+		HoudiniMassConversion::QuatsToRotators(Rotations.GetData(), NumPoints, Rots.GetData());
+		const double ToUnrealTime = FPlatformTime::Seconds() - StartTime;
+
+		// -------- Errors, so that we know kernels are still the same as scalar loops --------
+		float MaxPositionError = 0.0f;
+		float MaxRotationError = 0.0f;
+		double MaxRotatorError = 0.0;
+		for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+		{
+			for (int32 Idx = PointIdx * 3; Idx < PointIdx * 3 + 3; ++Idx)
+				MaxPositionError = FMath::Max(MaxPositionError, FMath::Abs(Positions[Idx] - ScalarPositions[Idx]));
+			for (int32 Idx = PointIdx * 4; Idx < PointIdx * 4 + 4; ++Idx)
+				MaxRotationError = FMath::Max(MaxRotationError, FMath::Abs(Rotations[Idx] - ScalarRotations[Idx]));
+			MaxPositionError = FMath::Max(MaxPositionError, float((OutPoints[PointIdx].Position - ScalarOutPoints[PointIdx].Position).GetAbsMax()));
+			MaxRotatorError = FMath::Max(MaxRotatorError, (Rots[PointIdx] - ScalarRots[PointIdx]).GetNormalized().GetManhattanDistance(FRotator::ZeroRotator));
+		}
+
+		UE_LOG(LogHoudiniEngine, Display, TEXT("HoudiniMass.BenchmarkConversion: iteration %d"), Iteration);
+		UE_LOG(LogHoudiniEngine, Display, TEXT("    To Houdini: scalar %s, vector %s"), *FormatRate(NumPoints, ScalarToHoudiniTime), *FormatRate(NumPoints, ToHoudiniTime));
+		UE_LOG(LogHoudiniEngine, Display, TEXT("    To Unreal:  scalar %s, vector %s"), *FormatRate(NumPoints, ScalarToUnrealTime), *FormatRate(NumPoints, ToUnrealTime));
+		UE_LOG(LogHoudiniEngine, Display, TEXT("    Max Error:  position %g, rotation %g, rotator %g"), MaxPositionError, MaxRotationError, MaxRotatorError);
+	}
+}
+
+static FAutoConsoleCommand HoudiniMassReplayZoneShapeOutputCommand(
+	TEXT("HoudiniMass.ReplayZoneShapeOutput"),
+	TEXT("Replay a zone shape output capture of HoudiniMass.CaptureZoneShapeOutput without houdini session. Usage: HoudiniMass.ReplayZoneShapeOutput <File> [Iterations=3]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.IsEmpty())
+			{
+				UE_LOG(LogHoudiniEngine, Error, TEXT("HoudiniMass.ReplayZoneShapeOutput: please specify a capture file"));
+				return;
+			}
+
+			const FString ArgsStr = FString::Join(Args, TEXT(" "));
+			int32 NumIterations = 3;
+			FParse::Value(*ArgsStr, TEXT("Iterations="), NumIterations);
+
+			FString FilePath = Args[0];
+			if (FPaths::IsRelative(FilePath) && !FPaths::FileExists(FilePath))
+				FilePath = FPaths::ProjectSavedDir() / TEXT("HoudiniMass") / FilePath;
+
+			HoudiniMassBenchmark::Replay(FilePath, FMath::Max(NumIterations, 1));
+		}));
+
+static FAutoConsoleCommand HoudiniMassBenchmarkCommand(
+	TEXT("HoudiniMass.Benchmark"),
+	TEXT("Benchmark zone shape input and output without houdini session. Usage: HoudiniMass.Benchmark [Shapes=1000] [Points=8] [Lanes=16] [Tags=4] [Iterations=3]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString ArgsStr = FString::Join(Args, TEXT(" "));
+			HoudiniMassBenchmark::FParams Params;
+			FParse::Value(*ArgsStr, TEXT("Shapes="), Params.NumShapes);
+			FParse::Value(*ArgsStr, TEXT("Points="), Params.NumPoints);
+			FParse::Value(*ArgsStr, TEXT("Lanes="), Params.NumLaneProfiles);
+			FParse::Value(*ArgsStr, TEXT("Tags="), Params.NumTags);
+			FParse::Value(*ArgsStr, TEXT("Iterations="), Params.NumIterations);
+
+			Params.NumShapes = FMath::Max(Params.NumShapes, 1);
+			Params.NumPoints = FMath::Max(Params.NumPoints, 2);
+			Params.NumLaneProfiles = FMath::Clamp(Params.NumLaneProfiles, 0, 250);  // Per point lane profile index is uint8
+			Params.NumTags = FMath::Clamp(Params.NumTags, 0, 32);
+			Params.NumIterations = FMath::Max(Params.NumIterations, 1);
+
+			HoudiniMassBenchmark::Run(Params);
+		}));
+
+static FAutoConsoleCommand HoudiniMassBenchmarkConversionCommand(
+	TEXT("HoudiniMass.BenchmarkConversion"),
+	TEXT("Benchmark position and rotation conversions between unreal and houdini. Usage: HoudiniMass.BenchmarkConversion [Points=1000000] [Iterations=3]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString ArgsStr = FString::Join(Args, TEXT(" "));
+			int32 NumPoints = 1000000;
+			int32 NumIterations = 3;
+			FParse::Value(*ArgsStr, TEXT("Points="), NumPoints);
+			FParse::Value(*ArgsStr, TEXT("Iterations="), NumIterations);
+
+			HoudiniMassBenchmark::RunConversion(FMath::Max(NumPoints, 1), FMath::Max(NumIterations, 1));
+		}));
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHoudiniZoneShapeRoundTripTest, "HoudiniMassTranslator.ZoneShape.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FHoudiniZoneShapeRoundTripTest::RunTest(const FString& Parameters)
+{
+	HoudiniMassBenchmark::FParams Params;
+	Params.NumShapes = 16;
+	Params.NumPoints = 5;
+	Params.NumLaneProfiles = 6;
+	Params.NumTags = 3;
+
+	TArray<FZoneLaneProfile> LaneProfiles;
+	HoudiniMassBenchmark::GenerateLaneProfiles(Params, LaneProfiles);
+
+	TArray<UZoneShapeComponent*> InputZSCs;
+	HoudiniMassBenchmark::GenerateShapes(Params, LaneProfiles, InputZSCs);
+
+	// -------- Gather -> Encode -> Part -> FHoudiniZoneShapeOutputTask --------
+	TArray<const UActorComponent*> Components;
+	TArray<FTransform> Transforms;
+	TArray<int32> ComponentIndices;
+	for (int32 ShapeIdx = 0; ShapeIdx < InputZSCs.Num(); ++ShapeIdx)
+	{
+		Components.Add(InputZSCs[ShapeIdx]);
+		Transforms.Add(FTransform::Identity);
+		ComponentIndices.Add(ShapeIdx);
+	}
+
+	FHoudiniZoneShapesInputData Data;
+	Data.Gather(Components, Transforms, ComponentIndices);
+	FHoudiniZoneGraphSettingsCache SettingsCache;
+	SettingsCache.Refresh(GetDefault<UZoneGraphSettings>());
+	Data.Encode(SettingsCache);
+
+	{
+		HoudiniMassBenchmark::FOutputEnvironment Environment;
+		TArray<FHoudiniZoneShapePart> Parts;
+		Parts.Add(HoudiniMassBenchmark::MakePart(Data, InputZSCs, LaneProfiles));
+		const TSharedPtr<FHoudiniZoneShapeOutputTask> Task = Environment.RunOutput(MoveTemp(Parts), LaneProfiles);
+		TestTrue(TEXT("Task finished"), Task->IsFinished());
+
+		// -------- Compare output components with input ones --------
+		auto GetPointLaneProfileIDLambda = [](const UZoneShapeComponent* ZSC, const FZoneShapePoint& Point) -> FGuid
+			{
+				if (Point.LaneProfile == FZoneShapePoint::InheritLaneProfile)
+					return ZSC->GetCommonLaneProfile().ID;
+				return ZSC->GetPerPointLaneProfiles().IsValidIndex(Point.LaneProfile) ? ZSC->GetPerPointLaneProfiles()[Point.LaneProfile].ID : FGuid();
+			};
+
+		const TArray<FHoudiniZoneShapeOutput>& ZSOutputs = Environment.Output->GetZoneShapeOutputs();
+		TestEqual(TEXT("Num shapes"), ZSOutputs.Num(), InputZSCs.Num());
+		for (int32 ShapeIdx = 0; ShapeIdx < FMath::Min(ZSOutputs.Num(), InputZSCs.Num()); ++ShapeIdx)
+		{
+			const UZoneShapeComponent* InputZSC = InputZSCs[ShapeIdx];
+			const UZoneShapeComponent* OutputZSC = ZSOutputs[ShapeIdx].Find(Environment.Node);
+			if (!TestNotNull(FString::Printf(TEXT("Shape %d"), ShapeIdx), OutputZSC))
+				continue;
+
+			TestEqual(FString::Printf(TEXT("Shape %d type"), ShapeIdx), int32(OutputZSC->GetShapeType()), int32(InputZSC->GetShapeType()));
+			TestTrue(FString::Printf(TEXT("Shape %d tags"), ShapeIdx), OutputZSC->GetTags() == InputZSC->GetTags());
+			TestTrue(FString::Printf(TEXT("Shape %d common lane profile"), ShapeIdx), OutputZSC->GetCommonLaneProfile().ID == InputZSC->GetCommonLaneProfile().ID);
+
+			const TConstArrayView<FZoneShapePoint> InputPoints = InputZSC->GetPoints();
+			const TConstArrayView<FZoneShapePoint> OutputPoints = OutputZSC->GetPoints();
+			if (!TestEqual(FString::Printf(TEXT("Shape %d num points"), ShapeIdx), OutputPoints.Num(), InputPoints.Num()))
+				continue;
+
+			for (int32 PointIdx = 0; PointIdx < InputPoints.Num(); ++PointIdx)
+			{
+				const FZoneShapePoint& InputPoint = InputPoints[PointIdx];
+				const FZoneShapePoint& OutputPoint = OutputPoints[PointIdx];
+				const FString What = FString::Printf(TEXT("Shape %d point %d"), ShapeIdx, PointIdx);
+				TestTrue(What + TEXT(" position"), OutputPoint.Position.Equals(InputPoint.Position, 0.1));  // Float in houdini space
+				TestTrue(What + TEXT(" rotation"), OutputPoint.Rotation.Quaternion().Equals(InputPoint.Rotation.Quaternion(), 1.e-4));
+				TestEqual(What + TEXT(" type"), int32(OutputPoint.Type), int32(InputPoint.Type));
+				TestTrue(What + TEXT(" lane profile"), GetPointLaneProfileIDLambda(OutputZSC, OutputPoint) == GetPointLaneProfileIDLambda(InputZSC, InputPoint));
+			}
+		}
+	}
+
+	for (UZoneShapeComponent* ZSC : InputZSCs)
+		ZSC->MarkAsGarbage();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHoudiniZoneGraphSettingsCacheTest, "HoudiniMassTranslator.ZoneGraphSettingsCache",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FHoudiniZoneGraphSettingsCacheTest::RunTest(const FString& Parameters)
+{
+	using FCache = FHoudiniZoneGraphSettingsCache;
+
+	// -------- Quantization --------
+	FZoneLaneDesc Lane;
+	Lane.Width = 350.0f;
+	Lane.Direction = EZoneLaneDirection::Forward;
+	Lane.Tags = FZoneGraphTagMask(1);
+
+	FZoneLaneDesc NoisyLane = Lane;
+	NoisyLane.Width = 350.0f + FCache::LaneWidthTolerance * 0.4f;  // Float noise from unit conversion
+	FZoneLaneDesc WiderLane = Lane;
+	WiderLane.Width = 350.0f + FCache::LaneWidthTolerance * 2.0f;
+
+	TestEqual(TEXT("Quantized noisy width"), FCache::QuantizeLaneWidth(NoisyLane.Width), FCache::QuantizeLaneWidth(Lane.Width));
+	TestTrue(TEXT("Noisy lane hash"), FCache::GetLaneHash(NoisyLane) == FCache::GetLaneHash(Lane));
+	TestTrue(TEXT("Noisy lane equivalent"), FCache::IsLaneEquivalent(NoisyLane, Lane));
+	TestFalse(TEXT("Wider lane equivalent"), FCache::IsLaneEquivalent(WiderLane, Lane));
+
+	FZoneLaneDesc CanonicalLane = NoisyLane;
+	CanonicalLane.Tags = FZoneGraphTagMask(0);
+	FCache::CanonicalizeLane(CanonicalLane);
+	TestTrue(TEXT("Canonical lane width"), FMath::IsNearlyEqual(CanonicalLane.Width, Lane.Width, 1.e-3f));
+	TestTrue(TEXT("Canonical lane tags"), CanonicalLane.Tags == FZoneGraphTagMask(1));  // Empty tags means the default tag
+
+	// -------- Encoding dedup --------
+	UZoneGraphSettings* ZoneGraphSettings = NewObject<UZoneGraphSettings>(GetTransientPackage(), NAME_None, RF_Transient);
+	TArray<FZoneLaneProfile>& LaneProfiles = *((TArray<FZoneLaneProfile>*)&ZoneGraphSettings->GetLaneProfiles());  // The same as FHoudiniZoneGraphSettingsCache::AddLaneProfile
+	LaneProfiles.Empty();
+
+	FCache Cache;
+	Cache.Refresh(ZoneGraphSettings);
+
+	FZoneLaneDesc BackwardLane = Lane;
+	BackwardLane.Direction = EZoneLaneDirection::Backward;
+	const int32 LaneEncodingIdx = Cache.FindOrAddLaneEncoding(Lane);
+	TestEqual(TEXT("Same lane encoding"), Cache.FindOrAddLaneEncoding(Lane), LaneEncodingIdx);
+	TestNotEqual(TEXT("Backward lane encoding"), Cache.FindOrAddLaneEncoding(BackwardLane), LaneEncodingIdx);
+	TestEqual(TEXT("Num lane encodings"), Cache.GetNumLaneEncodings(), 2);
+
+	const int32 NameEncodingIdx = Cache.FindOrAddNameEncoding(TEXT("LP_HE_Test"));
+	TestEqual(TEXT("Same name encoding"), Cache.FindOrAddNameEncoding(TEXT("LP_HE_Test")), NameEncodingIdx);
+	TestEqual(TEXT("Name encoding"), FString(UTF8_TO_TCHAR(Cache.GetNameEncoding(NameEncodingIdx))), FString(TEXT("LP_HE_Test")));
+
+	// Tags are in lane encodings, so they should be flushed once tags changed
+	bool bZoneGraphSettingsModified = false;
+	const FZoneGraphTagMask NewTag = Cache.FindOrCreateTag(ZoneGraphSettings, TEXT("HoudiniMassTestTag"), bZoneGraphSettingsModified);
+	TestTrue(TEXT("Tag created"), bZoneGraphSettingsModified);
+	TestTrue(TEXT("Same tag"), Cache.FindOrCreateTag(ZoneGraphSettings, TEXT("HoudiniMassTestTag"), bZoneGraphSettingsModified) == NewTag);
+	Cache.Refresh(ZoneGraphSettings);
+	TestEqual(TEXT("Lane encodings flushed"), Cache.GetNumLaneEncodings(), 0);
+
+	// -------- Lane profile dedup --------
+	auto MakeLaneProfileLambda = [](const TCHAR* Name, const TArray<FZoneLaneDesc>& Lanes)
+		{
+			FZoneLaneProfile LaneProfile;
+			LaneProfile.Name = Name;
+			LaneProfile.ID = FGuid::NewGuid();
+			LaneProfile.Lanes = Lanes;
+			return LaneProfile;
+		};
+
+	const TArray<FZoneLaneDesc> Lanes = { Lane, BackwardLane };
+	const TArray<FZoneLaneDesc> NoisyLanes = { NoisyLane, BackwardLane };
+	const TArray<FZoneLaneDesc> OtherLanes = { WiderLane, BackwardLane };
+	TestEqual(TEXT("Lane profile not found"), Cache.FindLaneProfile(ZoneGraphSettings, Lanes, FCache::GetLaneProfileHash(Lanes)), int32(INDEX_NONE));
+
+	const int32 ProfileIdx = Cache.AddLaneProfile(ZoneGraphSettings, MakeLaneProfileLambda(TEXT("LP_HE_A"), Lanes));
+	const int32 OtherProfileIdx = Cache.AddLaneProfile(ZoneGraphSettings, MakeLaneProfileLambda(TEXT("LP_HE_B"), OtherLanes));
+	TestEqual(TEXT("Lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, Lanes, FCache::GetLaneProfileHash(Lanes)), ProfileIdx);
+	TestEqual(TEXT("Noisy lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, NoisyLanes, FCache::GetLaneProfileHash(NoisyLanes)), ProfileIdx);
+	TestEqual(TEXT("Other lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, OtherLanes, FCache::GetLaneProfileHash(OtherLanes)), OtherProfileIdx);
+	TestEqual(TEXT("Lane profile found by name"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("LP_HE_B")), OtherProfileIdx);
+
+	// Lane profiles appended by user should be indexed incrementally
+	LaneProfiles.Add(MakeLaneProfileLambda(TEXT("User"), { WiderLane }));
+	TestEqual(TEXT("Appended lane profile found"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("User")), LaneProfiles.Num() - 1);
+
+	// -------- Invalidation, when lane profiles are reordered, renamed or removed in project settings --------
+	LaneProfiles.Swap(ProfileIdx, OtherProfileIdx);
+	TestEqual(TEXT("Reordered lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, Lanes, FCache::GetLaneProfileHash(Lanes)), OtherProfileIdx);
+	TestEqual(TEXT("Reordered lane profile found by name"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("LP_HE_B")), ProfileIdx);
+
+	LaneProfiles[ProfileIdx].Name = TEXT("LP_HE_Renamed");
+	TestEqual(TEXT("Renamed lane profile found by old name"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("LP_HE_B")), int32(INDEX_NONE));
+	TestEqual(TEXT("Renamed lane profile found by new name"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("LP_HE_Renamed")), ProfileIdx);
+
+	LaneProfiles.RemoveAt(OtherProfileIdx);
+	Cache.InvalidateLaneProfiles();
+	TestEqual(TEXT("Removed lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, Lanes, FCache::GetLaneProfileHash(Lanes)), int32(INDEX_NONE));
+	TestEqual(TEXT("Removed lane profile found by name"), Cache.FindLaneProfileByName(ZoneGraphSettings, TEXT("LP_HE_A")), int32(INDEX_NONE));
+	TestTrue(TEXT("Rest lane profile found"), Cache.FindLaneProfile(ZoneGraphSettings, OtherLanes, FCache::GetLaneProfileHash(OtherLanes)) != INDEX_NONE);
+
+	ZoneGraphSettings->MarkAsGarbage();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHoudiniLaneProfileRegistryTest, "HoudiniMassTranslator.LaneProfileRegistry",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FHoudiniLaneProfileRegistryTest::RunTest(const FString& Parameters)
+{
+	// A transient registry, so that DefaultEditor.ini and the registry of the editor are NOT touched
+	UHoudiniLaneProfileRegistry* Registry = NewObject<UHoudiniLaneProfileRegistry>(GetTransientPackage(), NAME_None, RF_Transient);
+	Registry->Empty();
+
+	const FGuid IdA = FGuid::NewGuid();
+	const FGuid IdB = FGuid::NewGuid();
+	const FGuid IdC = FGuid::NewGuid();
+
+	UHoudiniOutputZoneShape* Output1 = NewObject<UHoudiniOutputZoneShape>(GetTransientPackage(), NAME_None, RF_Transient);
+	UHoudiniOutputZoneShape* Output2 = NewObject<UHoudiniOutputZoneShape>(GetTransientPackage(), NAME_None, RF_Transient);
+
+	// -------- Ref counts --------
+	Registry->SetReferences(nullptr, Output1, { FHoudiniLaneProfileReferences{ FString(), { IdA, IdB } } });
+	Registry->SetReferences(nullptr, Output2, { FHoudiniLaneProfileReferences{ TEXT("Split"), { IdB } } });
+	TestTrue(TEXT("A referenced"), Registry->IsReferenced(IdA));
+	TestTrue(TEXT("B referenced"), Registry->IsReferenced(IdB));
+	TestFalse(TEXT("C referenced"), Registry->IsReferenced(IdC));
+
+	Registry->SetReferences(nullptr, Output1, { FHoudiniLaneProfileReferences{ FString(), { IdA } } });  // Output1 no longer uses B
+	TestTrue(TEXT("B referenced by Output2"), Registry->IsReferenced(IdB));
+
+	Registry->RemoveReferences(nullptr, Output2);
+	TestFalse(TEXT("B referenced after Output2 removed"), Registry->IsReferenced(IdB));
+	TestTrue(TEXT("A referenced after Output2 removed"), Registry->IsReferenced(IdA));
+
+	Registry->SetReferences(nullptr, Output1, {});  // Empty references remove the owner
+	TestFalse(TEXT("A referenced after Output1 emptied"), Registry->IsReferenced(IdA));
+
+	// -------- Prune --------
+	UPackage* Package = CreatePackage(*(TEXT("/Temp/HoudiniMassTest_") + FGuid::NewGuid().ToString()));
+	UHoudiniOutputZoneShape* Output3 = NewObject<UHoudiniOutputZoneShape>(Package, NAME_None, RF_Transient);
+	Registry->SetReferences(nullptr, Output3, { FHoudiniLaneProfileReferences{ FString(), { IdC } } });
+	Registry->Prune();
+	TestTrue(TEXT("C referenced by unsaved package"), Registry->IsReferenced(IdC));  // Unsaved packages are only in memory
+
+	Package->Rename(*(TEXT("/Temp/HoudiniMassTest_") + FGuid::NewGuid().ToString()), nullptr, REN_DontCreateRedirectors | REN_NonTransactional);  // As if the level is renamed
+	Registry->Prune();
+	TestFalse(TEXT("C referenced after package renamed"), Registry->IsReferenced(IdC));
+
+	Output1->MarkAsGarbage();
+	Output2->MarkAsGarbage();
+	Output3->MarkAsGarbage();
+	Package->MarkAsGarbage();
+	Registry->MarkAsGarbage();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHoudiniMassConversionTest, "HoudiniMassTranslator.Conversion",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FHoudiniMassConversionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumPoints = 1027;  // Not a multiple of vector width, so the tails are covered too
+
+	TArray<FZoneShapePoint> Points;
+	HoudiniMassBenchmark::GenerateConversionPoints(NumPoints, Points);
+	const FTransform& Transform = HoudiniMassBenchmark::ConversionTransform;
+
+	// -------- To houdini --------
+	TArray<float> ScalarPositions, ScalarRotations;
+	HoudiniMassBenchmark::ScalarToHoudini(Transform, Points, ScalarPositions, ScalarRotations);
+
+	TArray<float> Positions, Rotations;
+	Positions.SetNumUninitialized(NumPoints * 3);
+	Rotations.SetNumUninitialized(NumPoints * 4);
+	HoudiniMassConversion::PositionsToHoudini(Transform, Points, Positions.GetData());
+	HoudiniMassConversion::RotationsToHoudini(Transform, Points, Rotations.GetData());
+
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const FString What = FString::Printf(TEXT("Point %d"), PointIdx);
+		const FVector3f Pos(Positions[PointIdx * 3], Positions[PointIdx * 3 + 1], Positions[PointIdx * 3 + 2]);
+		const FVector3f ScalarPos(ScalarPositions[PointIdx * 3], ScalarPositions[PointIdx * 3 + 1], ScalarPositions[PointIdx * 3 + 2]);
+		TestTrue(What + TEXT(" to houdini position"), Pos.Equals(ScalarPos, 1.e-3f));  // Houdini units, float precision on km scale
+
+		const FQuat4f Rot(Rotations[PointIdx * 4], Rotations[PointIdx * 4 + 1], Rotations[PointIdx * 4 + 2], Rotations[PointIdx * 4 + 3]);
+		const FQuat4f ScalarRot(ScalarRotations[PointIdx * 4], ScalarRotations[PointIdx * 4 + 1], ScalarRotations[PointIdx * 4 + 2], ScalarRotations[PointIdx * 4 + 3]);
+		TestTrue(What + TEXT(" to houdini rotation"), Rot.Equals(ScalarRot, 1.e-5f));
+	}
+
+	// -------- To unreal, from the same houdini data --------
+	TArray<FZoneShapePoint> ScalarOutPoints;
+	TArray<FRotator> ScalarRots;
+	HoudiniMassBenchmark::ScalarToUnreal(Positions, Rotations, ScalarOutPoints, ScalarRots);
+
+	TArray<FZoneShapePoint> OutPoints;
+	OutPoints.SetNum(NumPoints);
+	TArray<FRotator> Rots;
+	Rots.SetNumUninitialized(NumPoints);
+	HoudiniMassConversion::PositionsToUnreal(Positions.GetData(), OutPoints);
+	HoudiniMassConversion::QuatsToRotators(Rotations.GetData(), NumPoints, Rots.GetData());
+
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const FString What = FString::Printf(TEXT("Point %d"), PointIdx);
+		TestTrue(What + TEXT(" to unreal position"), OutPoints[PointIdx].Position.Equals(ScalarOutPoints[PointIdx].Position, 0.1));
+		TestTrue(What + TEXT(" to unreal rotation"), Rots[PointIdx].Quaternion().Equals(ScalarRots[PointIdx].Quaternion(), 1.e-4));  // Rotators may differ near gimbal lock
+	}
+
+	return true;
+}
+
+#endif
@@ -3,9 +3,12 @@
 #include "HoudiniMassCommands.h"
 
 #include "ZoneGraphSettings.h"
-#include "ZoneShapeComponent.h"
 
+#include "HoudiniMassTranslator.h"
 #include "HoudiniMassCommon.h"
+#include "HoudiniLaneProfileRegistry.h"
+#include "HoudiniOutputZoneShape.h"
+#include "HoudiniZoneGraphSettingsCache.h"
 
 
 #define LOCTEXT_NAMESPACE "HoudiniMassTranslator"
@@ -24,44 +27,31 @@ void FHoudiniMassCommands::RegisterCommands()
 void FHoudiniMassCommands::OnCleanupLaneProfiles()
 {
 	UZoneGraphSettings* ZoneGraphSettings = GetMutableDefault<UZoneGraphSettings>();
-	TSet<FGuid> UsedLaneProfileIDs;
-	for (FThreadSafeObjectIterator Iter(UZoneShapeComponent::StaticClass()); Iter; ++Iter)
-	{
-		UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(*Iter);
-		if (!IsValid(ZSC))
-			continue;
+	UHoudiniLaneProfileRegistry* LaneProfileRegistry = UHoudiniLaneProfileRegistry::Get();
 
-		if (ZSC->GetShapeType() == FZoneShapeType::Spline)
-		{
-			FZoneLaneProfile LaneProfile;
-			ZSC->GetSplineLaneProfile(LaneProfile);
-			UsedLaneProfileIDs.Add(LaneProfile.ID);
-		}
-		else
+	// Loaded outputs may be cooked by previous versions, which have NOT recorded their references yet
+	for (TObjectIterator<UHoudiniOutputZoneShape> OutputIter; OutputIter; ++OutputIter)
+	{
+		if (IsValid(*OutputIter))
 		{
-			for (const FZoneShapePoint& Point : ZSC->GetMutablePoints())
-			{
-				if (Point.LaneProfile == FZoneShapePoint::InheritLaneProfile)
-				{
-					FZoneLaneProfile LaneProfile;
-					ZSC->GetSplineLaneProfile(LaneProfile);
-					UsedLaneProfileIDs.Add(LaneProfile.ID);
-				}
-				else if (ZSC->GetPerPointLaneProfiles().IsValidIndex(Point.LaneProfile))
-					UsedLaneProfileIDs.Add(ZSC->GetPerPointLaneProfiles()[Point.LaneProfile].ID);
-			}
+			OutputIter->RecoverLaneProfileReferences();
+			OutputIter->RegisterLaneProfileReferences();
 		}
 	}
 
-	((TArray<FZoneLaneProfile>*)&ZoneGraphSettings->GetLaneProfiles())->RemoveAll([UsedLaneProfileIDs](const FZoneLaneProfile& LaneProfile)
+	LaneProfileRegistry->Prune();  // Outputs of deleted, renamed or moved levels
+
+	((TArray<FZoneLaneProfile>*)&ZoneGraphSettings->GetLaneProfiles())->RemoveAll([&](const FZoneLaneProfile& LaneProfile)
 		{
 			FString Name = LaneProfile.Name.ToString();
 			if (Name.StartsWith(HOUDINI_LANE_PROFILE_PREFIX) && Name.Len() >= 7)
-				return !UsedLaneProfileIDs.Contains(LaneProfile.ID);
+				return !LaneProfileRegistry->IsReferenced(LaneProfile.ID);
 
 			return false;
 		});
+	FHoudiniMassTranslator::Get().GetZoneGraphSettingsCache().InvalidateLaneProfiles();
 	ZoneGraphSettings->TryUpdateDefaultConfigFile();
+	LaneProfileRegistry->SaveIfModified();
 }
 
 void FHoudiniMassCommands::OnRemoveAllLaneProfiles()
@@ -71,7 +61,12 @@ void FHoudiniMassCommands::OnRemoveAllLaneProfiles()
 		{
 			return LaneProfile.Name.ToString().StartsWith(HOUDINI_LANE_PROFILE_PREFIX);
 		});
+	FHoudiniMassTranslator::Get().GetZoneGraphSettingsCache().InvalidateLaneProfiles();
 	ZoneGraphSettings->TryUpdateDefaultConfigFile();
+
+	UHoudiniLaneProfileRegistry* LaneProfileRegistry = UHoudiniLaneProfileRegistry::Get();
+	LaneProfileRegistry->Empty();
+	LaneProfileRegistry->SaveIfModified();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,120 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniMassConversion.h"
+
+#include "HoudiniEngineUtils.h"
+
+
+void HoudiniMassConversion::PositionsToHoudini(const FTransform& Transform, const TConstArrayView<FZoneShapePoint>& Points, float* OutData)
+{
+	// Fold TransformPosition, scale and Y/Z swap into the rows of one matrix, so each point is 3 multiply-adds
+	const FMatrix Matrix = Transform.ToMatrixWithScale();
+	VectorRegister4Double Rows[4];
+	for (int32 RowIdx = 0; RowIdx < 4; ++RowIdx)
+		Rows[RowIdx] = MakeVectorRegisterDouble(Matrix.M[RowIdx][0] * POSITION_SCALE_TO_HOUDINI,
+			Matrix.M[RowIdx][2] * POSITION_SCALE_TO_HOUDINI, Matrix.M[RowIdx][1] * POSITION_SCALE_TO_HOUDINI, 0.0);
+
+	const int32 NumPoints = Points.Num();
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const FVector& Position = Points[PointIdx].Position;
+		VectorRegister4Double Result = VectorMultiplyAdd(VectorSetFloat1(Position.X), Rows[0], Rows[3]);
+		Result = VectorMultiplyAdd(VectorSetFloat1(Position.Y), Rows[1], Result);
+		Result = VectorMultiplyAdd(VectorSetFloat1(Position.Z), Rows[2], Result);
+		VectorStoreFloat3(MakeVectorRegisterFloatFromDouble(Result), OutData + PointIdx * 3);
+	}
+}
+
+void HoudiniMassConversion::RotationsToHoudini(const FTransform& Transform, const TConstArrayView<FZoneShapePoint>& Points, float* OutData)
+{
+	const FQuat& TransformRotation = Transform.GetRotation();
+	const VectorRegister4Double Rotation = MakeVectorRegisterDouble(TransformRotation.X, TransformRotation.Y, TransformRotation.Z, TransformRotation.W);
+	const VectorRegister4Float NegateW = MakeVectorRegisterFloat(1.0f, 1.0f, 1.0f, -1.0f);
+
+	const int32 NumPoints = Points.Num();
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const FQuat Quat = Points[PointIdx].Rotation.Quaternion();
+		const VectorRegister4Double Result = VectorQuaternionMultiply2(Rotation, MakeVectorRegisterDouble(Quat.X, Quat.Y, Quat.Z, Quat.W));
+		const VectorRegister4Float Swizzled = VectorMultiply(VectorSwizzle(MakeVectorRegisterFloatFromDouble(Result), 0, 2, 1, 3), NegateW);
+		VectorStore(Swizzled, OutData + PointIdx * 4);
+	}
+}
+
+void HoudiniMassConversion::PositionsToUnreal(const float* Data, const TArrayView<FZoneShapePoint>& OutPoints)
+{
+	const VectorRegister4Float Scale = VectorSetFloat1(float(POSITION_SCALE_TO_UNREAL));
+
+	const int32 NumPoints = OutPoints.Num();
+	for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+	{
+		const VectorRegister4Float Position = VectorMultiply(VectorSwizzle(VectorLoadFloat3(Data + PointIdx * 3), 0, 2, 1, 3), Scale);
+		alignas(16) float Result[4];
+		VectorStoreAligned(Position, Result);
+		OutPoints[PointIdx].Position = FVector(Result[0], Result[1], Result[2]);
+	}
+}
+
+void HoudiniMassConversion::QuatsToRotators(const float* Data, const int32& Num, FRotator* OutRots)
+{
+	// Structure of arrays, 4 quats per iteration, swizzle is free as we just pick the components
+	const VectorRegister4Float One = VectorOne();
+	const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+	const VectorRegister4Float RadToDeg = VectorSetFloat1(180.0f / UE_PI);
+	const VectorRegister4Float SingularityThreshold = VectorSetFloat1(0.4999995f);
+
+	int32 ElemIdx = 0;
+	for (; ElemIdx + 4 <= Num; ElemIdx += 4)
+	{
+		const float* Quats = Data + ElemIdx * 4;
+		const VectorRegister4Float X = MakeVectorRegisterFloat(Quats[0], Quats[4], Quats[8], Quats[12]);
+		const VectorRegister4Float Y = MakeVectorRegisterFloat(Quats[2], Quats[6], Quats[10], Quats[14]);
+		const VectorRegister4Float Z = MakeVectorRegisterFloat(Quats[1], Quats[5], Quats[9], Quats[13]);
+		const VectorRegister4Float W = MakeVectorRegisterFloat(-Quats[3], -Quats[7], -Quats[11], -Quats[15]);
+
+		const VectorRegister4Float SingularityTest = VectorSubtract(VectorMultiply(Z, X), VectorMultiply(W, Y));
+		if (VectorAnyGreaterThan(VectorAbs(SingularityTest), SingularityThreshold))  // Gimbal lock, rare, so use the scalar one
+		{
+			for (int32 Idx = ElemIdx; Idx < ElemIdx + 4; ++Idx)
+				OutRots[Idx] = FQuat(Data[Idx * 4], Data[Idx * 4 + 2], Data[Idx * 4 + 1], -Data[Idx * 4 + 3]).Rotator();
+			continue;
+		}
+
+		const VectorRegister4Float YawY = VectorMultiply(Two, VectorMultiplyAdd(W, Z, VectorMultiply(X, Y)));
+		const VectorRegister4Float YawX = VectorSubtract(One, VectorMultiply(Two, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z))));
+		const VectorRegister4Float RollY = VectorNegate(VectorMultiply(Two, VectorMultiplyAdd(W, X, VectorMultiply(Y, Z))));
+		const VectorRegister4Float RollX = VectorSubtract(One, VectorMultiply(Two, VectorMultiplyAdd(X, X, VectorMultiply(Y, Y))));
+
+		alignas(16) float Pitches[4];
+		alignas(16) float Yaws[4];
+		alignas(16) float Rolls[4];
+		VectorStoreAligned(VectorMultiply(VectorASin(VectorMultiply(Two, SingularityTest)), RadToDeg), Pitches);
+		VectorStoreAligned(VectorMultiply(VectorATan2(YawY, YawX), RadToDeg), Yaws);
+		VectorStoreAligned(VectorMultiply(VectorATan2(RollY, RollX), RadToDeg), Rolls);
+		for (int32 Idx = 0; Idx < 4; ++Idx)
+			OutRots[ElemIdx + Idx] = FRotator(Pitches[Idx], Yaws[Idx], Rolls[Idx]);
+	}
+
+	for (; ElemIdx < Num; ++ElemIdx)
+		OutRots[ElemIdx] = FQuat(Data[ElemIdx * 4], Data[ElemIdx * 4 + 2], Data[ElemIdx * 4 + 1], -Data[ElemIdx * 4 + 3]).Rotator();
+}
+
+void HoudiniMassConversion::EulersToRotators(const float* Data, const int32& Num, FRotator* OutRots)
+{
+	// 4 eulers are 3 registers
+	const VectorRegister4Float RadToDeg = VectorSetFloat1(180.0f / UE_PI);
+
+	int32 ElemIdx = 0;
+	for (; ElemIdx + 4 <= Num; ElemIdx += 4)
+	{
+		alignas(16) float Degrees[12];
+		VectorStoreAligned(VectorMultiply(VectorLoad(Data + ElemIdx * 3), RadToDeg), Degrees);
+		VectorStoreAligned(VectorMultiply(VectorLoad(Data + ElemIdx * 3 + 4), RadToDeg), Degrees + 4);
+		VectorStoreAligned(VectorMultiply(VectorLoad(Data + ElemIdx * 3 + 8), RadToDeg), Degrees + 8);
+		for (int32 Idx = 0; Idx < 4; ++Idx)
+			OutRots[ElemIdx + Idx] = FRotator(Degrees[Idx * 3], Degrees[Idx * 3 + 2], Degrees[Idx * 3 + 1]);
+	}
+
+	for (; ElemIdx < Num; ++ElemIdx)
+		OutRots[ElemIdx] = FRotator(FMath::RadiansToDegrees(Data[ElemIdx * 3]), FMath::RadiansToDegrees(Data[ElemIdx * 3 + 2]), FMath::RadiansToDegrees(Data[ElemIdx * 3 + 1]));
+}
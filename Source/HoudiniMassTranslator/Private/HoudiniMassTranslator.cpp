@@ -4,34 +4,64 @@
 
 #include "Editor.h"
 #include "ToolMenus.h"
+#include "UObject/ObjectSaveContext.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Settings/ProjectPackagingSettings.h"
+#include "ZoneGraphData.h"
 #include "ZoneGraphDelegates.h"
+#include "ZoneGraphSettings.h"
 
 #include "HoudiniEngine.h"
 #include "HoudiniInputZoneShape.h"
+#include "HoudiniInputZoneGraph.h"
 #include "HoudiniOutputZoneShape.h"
+#include "HoudiniOutputZoneGraph.h"
 #include "HoudiniMassCommands.h"
+#include "HoudiniMassCommon.h"
+#include "HoudiniMassSettings.h"
+#include "HoudiniLaneProfileRegistry.h"
+#include "HoudiniZoneGraphSettingsCache.h"
+#include "HoudiniZoneShapeSpatialIndex.h"
 
 
 #define LOCTEXT_NAMESPACE "FHoudiniMassTranslatorModule"
 
+DEFINE_STAT(STAT_HoudiniMass_HapiCalls);
+DEFINE_STAT(STAT_HoudiniMass_HapiHelperCalls);
+DEFINE_STAT(STAT_HoudiniMass_InputShapes);
+DEFINE_STAT(STAT_HoudiniMass_InputPoints);
+DEFINE_STAT(STAT_HoudiniMass_OutputCurves);
+DEFINE_STAT(STAT_HoudiniMass_OutputPoints);
+DEFINE_STAT(STAT_HoudiniMass_UniqueLanes);
+DEFINE_STAT(STAT_HoudiniMass_LaneProfilesCreated);
+
 FHoudiniMassTranslator* FHoudiniMassTranslator::HoudiniMassTranslatorInstance = nullptr;
 
 void FHoudiniMassTranslator::StartupModule()
 {
 	HoudiniMassTranslatorInstance = this;
 
+	ZoneGraphSettingsCache = MakeShared<FHoudiniZoneGraphSettingsCache>();
+
+	ZoneShapeSpatialIndex = MakeShared<FHoudiniZoneShapeSpatialIndex>();
+	ZoneShapeSpatialIndex->Initialize();
+
 	FHoudiniEngine& HoudiniEngine = FHoudiniEngine::IsLoaded() ? FHoudiniEngine::Get() :
 		FModuleManager::LoadModuleChecked<FHoudiniEngine>("HoudiniEngine");
 	
 	ComponentInputBuilder = MakeShared<FHoudiniZoneShapeComponentInputBuilder>();
 	HoudiniEngine.RegisterInputBuilder(ComponentInputBuilder);
 
+	ZoneGraphInputBuilder = MakeShared<FHoudiniZoneGraphDataInputBuilder>();
+	HoudiniEngine.RegisterInputBuilder(ZoneGraphInputBuilder);
+
 	OutputBuilder = MakeShared<FHoudiniZoneShapeOutputBuilder>();
 	HoudiniEngine.RegisterOutputBuilder(OutputBuilder);
 
+	ZoneGraphOutputBuilder = MakeShared<FHoudiniZoneGraphOutputBuilder>();
+	HoudiniEngine.RegisterOutputBuilder(ZoneGraphOutputBuilder);
+
 	FHoudiniMassCommands::Register();
 
 	Commands = MakeShareable(new FUICommandList);
@@ -55,7 +85,18 @@ void FHoudiniMassTranslator::StartupModule()
 	}
 
 	UE::ZoneGraphDelegates::OnZoneGraphDataBuildDone.AddRaw(this, &FHoudiniMassTranslator::OnZoneGraphBuildDone);
+	UE::ZoneGraphDelegates::OnPostZoneGraphDataAdded.AddRaw(this, &FHoudiniMassTranslator::OnZoneGraphDataAdded);
 	FEditorDelegates::BeginPIE.AddRaw(this, &FHoudiniMassTranslator::OnZoneGraphBuildCancel);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FHoudiniMassTranslator::OnObjectPropertyChanged);
+
+	// Time-sliced outputs have swapped in their new holders, so they must finish before the world is saved, played or unloaded
+	FEditorDelegates::PreSaveWorldWithContext.AddRaw(this, &FHoudiniMassTranslator::OnPreSaveWorld);
+	FEditorDelegates::PreBeginPIE.AddRaw(this, &FHoudiniMassTranslator::OnPreBeginPIE);
+	FEditorDelegates::MapChange.AddRaw(this, &FHoudiniMassTranslator::OnMapChange);
+	FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FHoudiniMassTranslator::OnLevelRemovedFromWorld);
+
+	// Lane profile references are only written into config when outputs are saved, rather than every cook
+	UPackage::PackageSavedWithContextEvent.AddRaw(this, &FHoudiniMassTranslator::OnPackageSaved);
 
 	// We need to ignore this plugin's content while unreal cooking
 	UProjectPackagingSettings* PackagingSettings = GetMutableDefault<UProjectPackagingSettings>();
@@ -67,27 +108,125 @@ void FHoudiniMassTranslator::StartupModule()
 	}
 }
 
+void FHoudiniMassTranslator::AddNotification(const FText& Text)
+{
+	FNotificationInfo Info(Text);
+	Info.bFireAndForget = false;
+	Info.FadeInDuration = 0.05f;
+	Info.ExpireDuration = 0.2f;
+	Info.FadeOutDuration = 0.3f;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("HoudiniZoneGraphBuild", "Build Zone Graph"), FText::GetEmpty(),
+		FSimpleDelegate::CreateLambda([]() { UE::ZoneGraphDelegates::OnZoneGraphRequestRebuild.Broadcast(); }), SNotificationItem::CS_None));
+	Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("HoudiniZoneGraphBuildCancel", "Cancel"), FText::GetEmpty(),
+		FSimpleDelegate::CreateLambda([]() { FHoudiniMassTranslator::Get().OnZoneGraphBuildCancel(false); }), SNotificationItem::CS_None));
+	Info.bUseSuccessFailIcons = true;
+	Notification = FSlateNotificationManager::Get().AddNotification(Info);
+}
+
 void FHoudiniMassTranslator::OnZoneShapeOutputFinish()
 {
+	if (!ZoneShapeOutputTasks.IsEmpty())  // Should wait for the time-sliced outputs
+	{
+		bZoneShapeOutputTasksChanged = true;
+		return;
+	}
+
+	const FText FinishText = LOCTEXT("HoudiniZoneShapeOutputFinish", "Houdini Zone Shape Output Finished\nPlease Build Zone Graph");
 	if (!Notification.IsValid())
+		AddNotification(FinishText);
+	else if (Notification.Pin()->GetCompletionState() == SNotificationItem::CS_Pending)  // Was showing the progress
+	{
+		Notification.Pin()->SetText(FinishText);
+		Notification.Pin()->SetCompletionState(SNotificationItem::CS_None);  // Show the buttons
+	}
+}
+
+void FHoudiniMassTranslator::AddZoneShapeOutputTask(const TSharedPtr<FHoudiniZoneShapeOutputTask>& Task)
+{
+	ZoneShapeOutputTasks.Add(Task);
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHoudiniMassTranslator::OnTick));
+}
+
+void FHoudiniMassTranslator::FlushZoneShapeOutputTasks()
+{
+	if (ZoneShapeOutputTasks.IsEmpty())
+		return;
+
+	for (const TSharedPtr<FHoudiniZoneShapeOutputTask>& Task : ZoneShapeOutputTasks)
 	{
-		FNotificationInfo Info(LOCTEXT("HoudiniZoneShapeOutputFinish", "Houdini Zone Shape Output Finished\nPlease Build Zone Graph"));
-		Info.bFireAndForget = false;
-		Info.FadeInDuration = 0.05f;
-		Info.ExpireDuration = 0.2f;
-		Info.FadeOutDuration = 0.3f;
-		Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("HoudiniZoneGraphBuild", "Build Zone Graph"), FText::GetEmpty(),
-			FSimpleDelegate::CreateLambda([]() { UE::ZoneGraphDelegates::OnZoneGraphRequestRebuild.Broadcast(); }), SNotificationItem::CS_None));
-		Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("HoudiniZoneGraphBuildCancel", "Cancel"), FText::GetEmpty(),
-			FSimpleDelegate::CreateLambda([]() { FHoudiniMassTranslator::Get().OnZoneGraphBuildCancel(false); }), SNotificationItem::CS_None));
-		Info.bUseSuccessFailIcons = true;
-		Notification = FSlateNotificationManager::Get().AddNotification(Info);
-		//Notification.Pin()->SetCompletionState(SNotificationItem::CS_Pending);
+		if (!Task->IsFinished())
+			Task->Process(DBL_MAX);
 	}
+
+	if (TickerHandle.IsValid())
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	OnTick(0.0f);  // All tasks have finished, so this only removes them and notifies
+}
+
+bool FHoudiniMassTranslator::OnTick(float DeltaTime)
+{
+	const double EndTime = FPlatformTime::Seconds() + GetDefault<UHoudiniMassSettings>()->ZoneShapeOutputFrameBudget * 0.001;
+	for (const TSharedPtr<FHoudiniZoneShapeOutputTask>& Task : ZoneShapeOutputTasks)
+	{
+		if (!Task->IsFinished() && !Task->Process(EndTime))
+			break;
+	}
+
+	float Progress = 0.0f;
+	ZoneShapeOutputTasks.RemoveAll([&](const TSharedPtr<FHoudiniZoneShapeOutputTask>& Task)
+		{
+			if (Task->IsFinished())
+			{
+				bZoneShapeOutputTasksChanged |= Task->HasChangedShapes();
+				return true;
+			}
+
+			Progress += Task->GetProgress();
+			return false;
+		});
+
+	if (ZoneShapeOutputTasks.IsEmpty())
+	{
+		TickerHandle.Reset();
+		if (bZoneShapeOutputTasksChanged)
+			OnZoneShapeOutputFinish();
+		else if (Notification.IsValid() && (Notification.Pin()->GetCompletionState() == SNotificationItem::CS_Pending))
+		{
+			Notification.Pin()->SetCompletionState(SNotificationItem::CS_Success);
+			Notification.Pin()->ExpireAndFadeout();
+			Notification.Reset();
+		}
+		bZoneShapeOutputTasksChanged = false;
+		return false;
+	}
+
+	const FText ProgressText = FText::Format(LOCTEXT("HoudiniZoneShapeOutputProgress", "Houdini Zone Shape Output: {0}"),
+		FText::AsPercent(Progress / ZoneShapeOutputTasks.Num()));
+	if (!Notification.IsValid())
+		AddNotification(ProgressText);
+	else
+		Notification.Pin()->SetText(ProgressText);
+
+	if (Notification.IsValid())
+		Notification.Pin()->SetCompletionState(SNotificationItem::CS_Pending);  // Buttons will be hidden until all tasks finished
+
+	return true;
 }
 
 void FHoudiniMassTranslator::OnZoneGraphBuildDone(const FZoneGraphBuildData&)
 {
+	// Zone graph build will overwrite all zone graph data of the editor world by zone shapes, so we should restore the lanes output by houdini
+	const UWorld* BuiltWorld = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	if (BuiltWorld)
+	{
+		for (TObjectIterator<UHoudiniOutputZoneGraph> OutputIter; OutputIter; ++OutputIter)
+		{
+			if (IsValid(*OutputIter) && !OutputIter->HasAnyFlags(RF_ClassDefaultObject))
+				OutputIter->RestoreStorage(BuiltWorld);
+		}
+	}
+
 	if (Notification.IsValid())
 	{
 		Notification.Pin()->SetCompletionState(SNotificationItem::CS_Success);
@@ -96,6 +235,19 @@ void FHoudiniMassTranslator::OnZoneGraphBuildDone(const FZoneGraphBuildData&)
 	}
 }
 
+void FHoudiniMassTranslator::OnZoneGraphDataAdded(const AZoneGraphData* ZoneGraphData)
+{
+	// Zone graph data may be loaded after outputs, so capture the lanes output by houdini before any zone graph build
+	if (!ZoneGraphData || !ZoneGraphData->GetWorld() || ZoneGraphData->GetWorld()->IsGameWorld())
+		return;
+
+	for (TObjectIterator<UHoudiniOutputZoneGraph> OutputIter; OutputIter; ++OutputIter)
+	{
+		if (IsValid(*OutputIter) && !OutputIter->HasAnyFlags(RF_ClassDefaultObject) && (OutputIter->GetZoneGraphData().Get() == ZoneGraphData))
+			OutputIter->CaptureStorage();
+	}
+}
+
 void FHoudiniMassTranslator::OnZoneGraphBuildCancel(const bool)
 {
 	if (Notification.IsValid())
@@ -109,16 +261,78 @@ void FHoudiniMassTranslator::OnZoneGraphBuildCancel(const bool)
 	}
 }
 
+void FHoudiniMassTranslator::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent&)
+{
+	if (Object && Object->IsA<UZoneGraphSettings>())  // Lane profiles may be renamed or reordered by user in project settings
+		ZoneGraphSettingsCache->InvalidateLaneProfiles();
+}
+
+void FHoudiniMassTranslator::OnPreSaveWorld(UWorld*, FObjectPreSaveContext)
+{
+	FlushZoneShapeOutputTasks();
+}
+
+void FHoudiniMassTranslator::OnPreBeginPIE(const bool)
+{
+	FlushZoneShapeOutputTasks();
+}
+
+void FHoudiniMassTranslator::OnMapChange(uint32)
+{
+	FlushZoneShapeOutputTasks();
+}
+
+void FHoudiniMassTranslator::OnLevelRemovedFromWorld(ULevel*, UWorld*)
+{
+	FlushZoneShapeOutputTasks();
+}
+
+void FHoudiniMassTranslator::OnPackageSaved(const FString&, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	if (ObjectSaveContext.IsProceduralSave() || (ObjectSaveContext.GetSaveFlags() & SAVE_FromAutosave))
+		return;
+
+	// Re-register after saved, as "Save As" or saving a new level only gives outputs their final package here
+	ForEachObjectWithPackage(Package, [](UObject* Object)
+		{
+			if (const UHoudiniOutputZoneShape* Output = Cast<UHoudiniOutputZoneShape>(Object))
+				Output->RegisterLaneProfileReferences();
+			return true;
+		});
+	UHoudiniLaneProfileRegistry::Get()->SaveIfModified();
+}
+
 void FHoudiniMassTranslator::ShutdownModule()
 {
 	if (FHoudiniEngine::IsLoaded())
 	{
 		FHoudiniEngine::Get().UnregisterInputBuilder(ComponentInputBuilder);
+		FHoudiniEngine::Get().UnregisterInputBuilder(ZoneGraphInputBuilder);
 		FHoudiniEngine::Get().UnregisterOutputBuilder(OutputBuilder);
+		FHoudiniEngine::Get().UnregisterOutputBuilder(ZoneGraphOutputBuilder);
 	}
 
+	if (ZoneShapeSpatialIndex.IsValid())
+		ZoneShapeSpatialIndex->Deinitialize();
+
 	UE::ZoneGraphDelegates::OnZoneGraphDataBuildDone.RemoveAll(this);
+	UE::ZoneGraphDelegates::OnPostZoneGraphDataAdded.RemoveAll(this);
 	FEditorDelegates::BeginPIE.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+	FEditorDelegates::PreSaveWorldWithContext.RemoveAll(this);
+	FEditorDelegates::PreBeginPIE.RemoveAll(this);
+	FEditorDelegates::MapChange.RemoveAll(this);
+	FWorldDelegates::LevelRemovedFromWorld.RemoveAll(this);
+	UPackage::PackageSavedWithContextEvent.RemoveAll(this);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	ZoneShapeOutputTasks.Empty();
+
+	ZoneGraphSettingsCache.Reset();
 
 	HoudiniMassTranslatorInstance = nullptr;
 }
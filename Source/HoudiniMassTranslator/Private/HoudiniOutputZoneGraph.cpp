@@ -0,0 +1,530 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniOutputZoneGraph.h"
+
+#include "ZoneGraphData.h"
+#include "ZoneGraphSubsystem.h"
+#include "EngineUtils.h"
+
+#include "HoudiniApi.h"
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+#include "HoudiniMassCommon.h"
+#include "HoudiniZoneGraphSettingsCache.h"
+
+
+bool FHoudiniZoneGraphOutputBuilder::HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput)
+{
+	bOutShouldHoldByOutput = true;
+	bOutIsValid = false;
+
+	if (PartInfo.type == HAPI_PARTTYPE_CURVE)  // Each curve is a lane
+	{
+		const int32& PartId = PartInfo.id;
+
+		HAPI_AttributeInfo AttribInfo;
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_GRAPH, HAPI_ATTROWNER_DETAIL, &AttribInfo));
+
+		if (AttribInfo.exists && !FHoudiniEngineUtils::IsArray(AttribInfo.storage) &&
+			FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::Int)  // Only support i@unreal_output_zone_graph = 1 on detail
+		{
+			int bIsZoneGraph = 0;
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_GRAPH, &AttribInfo, 1, &bIsZoneGraph, 0, 1));
+
+			bOutIsValid = bool(bIsZoneGraph);
+			return true;
+		}
+	}
+
+	return true;
+}
+
+
+namespace HoudiniZoneGraphOutputUtils
+{
+	static bool HapiGetPrimIntData(const int32& NodeId, const int32& PartId, const char* AttribName, TArray<int32>& OutData);
+
+	static bool HapiGetPrimIntArrayData(const int32& NodeId, const int32& PartId, const char* AttribName, TArray<int32>& OutData, TArray<int32>& OutCounts);
+
+	static bool HapiAppendLanes(const int32& NodeId, const HAPI_PartInfo& PartInfo, FZoneGraphStorage& Storage);
+}
+
+bool HoudiniZoneGraphOutputUtils::HapiGetPrimIntData(const int32& NodeId, const int32& PartId, const char* AttribName, TArray<int32>& OutData)
+{
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+		NodeId, PartId, AttribName, HAPI_ATTROWNER_PRIM, &AttribInfo));
+
+	if (!AttribInfo.exists || (AttribInfo.tupleSize != 1) || FHoudiniEngineUtils::IsArray(AttribInfo.storage) ||
+		(FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) != EHoudiniStorageType::Int))
+		return true;
+
+	OutData.SetNumUninitialized(AttribInfo.count);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		AttribName, &AttribInfo, 1, OutData.GetData(), 0, AttribInfo.count));
+
+	return true;
+}
+
+bool HoudiniZoneGraphOutputUtils::HapiGetPrimIntArrayData(const int32& NodeId, const int32& PartId, const char* AttribName, TArray<int32>& OutData, TArray<int32>& OutCounts)
+{
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+		NodeId, PartId, AttribName, HAPI_ATTROWNER_PRIM, &AttribInfo));
+
+	if (!AttribInfo.exists || (AttribInfo.storage != HAPI_STORAGETYPE_INT_ARRAY))
+		return true;
+
+	OutCounts.SetNumUninitialized(AttribInfo.count);
+	OutData.SetNumUninitialized(AttribInfo.totalArrayElements);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		AttribName, &AttribInfo, OutData.GetData(), AttribInfo.totalArrayElements, OutCounts.GetData(), 0, AttribInfo.count));
+
+	return true;
+}
+
+bool HoudiniZoneGraphOutputUtils::HapiAppendLanes(const int32& NodeId, const HAPI_PartInfo& PartInfo, FZoneGraphStorage& Storage)
+{
+	const int32& PartId = PartInfo.id;
+	const int32& NumCurves = PartInfo.faceCount;
+
+	// -------- Retrieve lane geometry --------
+	TArray<int32> CurveCounts;
+	CurveCounts.SetNumUninitialized(NumCurves);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetCurveCounts(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		CurveCounts.GetData(), 0, NumCurves));
+
+	HAPI_AttributeInfo AttribInfo;
+	TArray<float> PositionData;
+	PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+
+	TArray<float> NormalData;  // Optional lane up vectors
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_NORMAL, HAPI_ATTROWNER_POINT, &AttribInfo));
+	if (AttribInfo.exists && (AttribInfo.tupleSize == 3) && !FHoudiniEngineUtils::IsArray(AttribInfo.storage) &&
+		(FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::Float))
+	{
+		NormalData.SetNumUninitialized(PartInfo.pointCount * 3);
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_NORMAL, &AttribInfo, -1, NormalData.GetData(), 0, PartInfo.pointCount));
+	}
+
+	TArray<float> Widths;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, HAPI_ATTROWNER_PRIM, &AttribInfo));
+	if (AttribInfo.exists && (AttribInfo.tupleSize == 1) && !FHoudiniEngineUtils::IsArray(AttribInfo.storage) &&
+		(FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::Float))
+	{
+		Widths.SetNumUninitialized(NumCurves);
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, &AttribInfo, 1, Widths.GetData(), 0, NumCurves));
+	}
+
+	TArray<int32> TagMasks;
+	HOUDINI_FAIL_RETURN(HapiGetPrimIntData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_TAGS, TagMasks));
+
+	TArray<int32> ZoneKeys;
+	HOUDINI_FAIL_RETURN(HapiGetPrimIntData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_GRAPH_ZONE, ZoneKeys));
+
+	// -------- Retrieve lane links, values are prim indices in this part --------
+	TArray<int32> Outgoings, OutgoingCounts;
+	HOUDINI_FAIL_RETURN(HapiGetPrimIntArrayData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_OUTGOING, Outgoings, OutgoingCounts));
+
+	TArray<int32> LeftLanes, RightLanes;
+	HOUDINI_FAIL_RETURN(HapiGetPrimIntData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_LEFT, LeftLanes));
+	HOUDINI_FAIL_RETURN(HapiGetPrimIntData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_RIGHT, RightLanes));
+
+	TArray<TArray<int32, TInlineAllocator<4>>> CurveOutgoings;
+	TArray<TArray<int32, TInlineAllocator<4>>> CurveIncomings;  // Derived from outgoings
+	CurveOutgoings.SetNum(NumCurves);
+	CurveIncomings.SetNum(NumCurves);
+	if (!OutgoingCounts.IsEmpty())
+	{
+		int32 ArrayIdx = 0;
+		for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+		{
+			for (int32 LinkIdx = 0; LinkIdx < OutgoingCounts[CurveIdx]; ++LinkIdx)
+			{
+				const int32& DestCurveIdx = Outgoings[ArrayIdx + LinkIdx];
+				if ((DestCurveIdx < 0) || (DestCurveIdx >= NumCurves) || (DestCurveIdx == CurveIdx))
+					continue;
+
+				CurveOutgoings[CurveIdx].AddUnique(DestCurveIdx);
+				CurveIncomings[DestCurveIdx].AddUnique(CurveIdx);
+			}
+			ArrayIdx += OutgoingCounts[CurveIdx];
+		}
+	}
+
+	// -------- Group curves by zone, lanes of a zone must be contiguous --------
+	TArray<TArray<int32>> ZoneCurveIndices;
+	{
+		TMap<int32, int32> ZoneKeyIdxMap;
+		for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+		{
+			if (CurveCounts[CurveIdx] < 2)  // Lane must have at least 2 points
+				continue;
+
+			if (ZoneKeys.IsEmpty())  // Each lane is a zone by default
+				ZoneCurveIndices.AddDefaulted_GetRef().Add(CurveIdx);
+			else
+			{
+				int32& ZoneIdx = ZoneKeyIdxMap.FindOrAdd(ZoneKeys[CurveIdx], INDEX_NONE);
+				if (ZoneIdx == INDEX_NONE)
+				{
+					ZoneIdx = ZoneCurveIndices.Num();
+					ZoneCurveIndices.AddDefaulted();
+				}
+				ZoneCurveIndices[ZoneIdx].Add(CurveIdx);
+			}
+		}
+	}
+
+	TArray<int32> VertexIndices;  // Start vertex index of each curve
+	VertexIndices.SetNumUninitialized(NumCurves);
+	int32 NumVertices = 0;
+	for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+	{
+		VertexIndices[CurveIdx] = NumVertices;
+		NumVertices += CurveCounts[CurveIdx];
+	}
+
+	TArray<int32> CurveLaneIndices;
+	CurveLaneIndices.Init(INDEX_NONE, NumCurves);
+	{
+		int32 LaneIdx = Storage.Lanes.Num();
+		for (const TArray<int32>& CurveIndices : ZoneCurveIndices)
+		{
+			for (const int32& CurveIdx : CurveIndices)
+				CurveLaneIndices[CurveIdx] = LaneIdx++;
+		}
+	}
+
+	// -------- Append zones and lanes --------
+	int32 NextEntryId = 0;
+	for (const FZoneLaneData& Lane : Storage.Lanes)
+		NextEntryId = FMath::Max(NextEntryId, FMath::Max(Lane.StartEntryId, Lane.EndEntryId) + 1);
+
+	const int32 LaneStartIdx = Storage.Lanes.Num();
+	for (const TArray<int32>& CurveIndices : ZoneCurveIndices)
+	{
+		FZoneData& Zone = Storage.Zones.AddDefaulted_GetRef();
+		Zone.Bounds.Init();
+		Zone.BoundaryPointsBegin = Storage.BoundaryPoints.Num();
+		Zone.BoundaryPointsEnd = Storage.BoundaryPoints.Num();
+		Zone.LanesBegin = Storage.Lanes.Num();
+		for (const int32& CurveIdx : CurveIndices)
+		{
+			FZoneLaneData& Lane = Storage.Lanes.AddDefaulted_GetRef();
+			Lane.ZoneIndex = Storage.Zones.Num() - 1;
+			Lane.Width = Widths.IsEmpty() ? FZoneLaneDesc().Width : (Widths[CurveIdx] * POSITION_SCALE_TO_UNREAL_F);
+			Lane.Tags = FHoudiniZoneGraphSettingsCache::CanonicalizeTags(TagMasks.IsEmpty() ? FZoneGraphTagMask(0) : FZoneGraphTagMask(uint32(TagMasks[CurveIdx])));  // The same as zone shape output
+			Zone.Tags.Add(Lane.Tags);
+
+			Lane.PointsBegin = Storage.LanePoints.Num();
+			const int32& StartVertexIdx = VertexIndices[CurveIdx];
+			const int32& NumPoints = CurveCounts[CurveIdx];
+			float Progression = 0.0f;
+			for (int32 PointIdx = 0; PointIdx < NumPoints; ++PointIdx)
+			{
+				const int32 GlobalPointIdx = StartVertexIdx + PointIdx;
+				const FVector Position = FVector(PositionData[GlobalPointIdx * 3], PositionData[GlobalPointIdx * 3 + 2], PositionData[GlobalPointIdx * 3 + 1]) * POSITION_SCALE_TO_UNREAL;
+				if (PointIdx >= 1)
+					Progression += FVector::Dist(Storage.LanePoints.Last(), Position);
+				Storage.LanePoints.Add(Position);
+				Storage.LanePointProgressions.Add(Progression);
+				Storage.LaneUpVectors.Add(NormalData.IsEmpty() ? FVector::UpVector :
+					FVector(NormalData[GlobalPointIdx * 3], NormalData[GlobalPointIdx * 3 + 2], NormalData[GlobalPointIdx * 3 + 1]).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector));
+				Zone.Bounds += FBox::BuildAABB(Position, FVector(Lane.Width * 0.5));
+			}
+			Lane.PointsEnd = Storage.LanePoints.Num();
+
+			for (int32 PointIdx = Lane.PointsBegin; PointIdx < Lane.PointsEnd; ++PointIdx)
+			{
+				const FVector& Prev = Storage.LanePoints[FMath::Max(PointIdx - 1, Lane.PointsBegin)];
+				const FVector& Next = Storage.LanePoints[FMath::Min(PointIdx + 1, Lane.PointsEnd - 1)];
+				Storage.LaneTangentVectors.Add((Next - Prev).GetSafeNormal());
+			}
+		}
+		Zone.LanesEnd = Storage.Lanes.Num();
+	}
+
+	// -------- Append lane links --------
+	auto GetLaneTangentLambda = [&Storage](const int32& LaneIdx)
+		{
+			const FZoneLaneData& Lane = Storage.Lanes[LaneIdx];
+			return (Storage.LanePoints[Lane.PointsEnd - 1] - Storage.LanePoints[Lane.PointsBegin]).GetSafeNormal();
+		};
+
+	for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)
+	{
+		const int32& LaneIdx = CurveLaneIndices[CurveIdx];
+		if (LaneIdx == INDEX_NONE)
+			continue;
+
+		FZoneLaneData& Lane = Storage.Lanes[LaneIdx];
+		Lane.LinksBegin = Storage.LaneLinks.Num();
+
+		const EZoneLaneLinkFlags OutgoingFlags = (CurveOutgoings[CurveIdx].Num() >= 2) ? EZoneLaneLinkFlags::Splitting : EZoneLaneLinkFlags::None;
+		for (const int32& DestCurveIdx : CurveOutgoings[CurveIdx])
+		{
+			if (CurveLaneIndices[DestCurveIdx] != INDEX_NONE)
+				Storage.LaneLinks.Add(FZoneLaneLinkData(CurveLaneIndices[DestCurveIdx], EZoneLaneLinkType::Outgoing, OutgoingFlags));
+		}
+
+		const EZoneLaneLinkFlags IncomingFlags = (CurveIncomings[CurveIdx].Num() >= 2) ? EZoneLaneLinkFlags::Merging : EZoneLaneLinkFlags::None;
+		for (const int32& SrcCurveIdx : CurveIncomings[CurveIdx])
+		{
+			const int32& SrcLaneIdx = CurveLaneIndices[SrcCurveIdx];
+			if (SrcLaneIdx == INDEX_NONE)
+				continue;
+
+			Storage.LaneLinks.Add(FZoneLaneLinkData(SrcLaneIdx, EZoneLaneLinkType::Incoming, IncomingFlags));
+		}
+
+		auto AddAdjacentLambda = [&](const TArray<int32>& AdjacentCurveIndices, const EZoneLaneLinkFlags& SideFlag)
+			{
+				if (AdjacentCurveIndices.IsEmpty())
+					return;
+
+				const int32& AdjacentCurveIdx = AdjacentCurveIndices[CurveIdx];
+				if ((AdjacentCurveIdx < 0) || (AdjacentCurveIdx >= NumCurves) || (CurveLaneIndices[AdjacentCurveIdx] == INDEX_NONE))
+					return;
+
+				const int32& AdjacentLaneIdx = CurveLaneIndices[AdjacentCurveIdx];
+				EZoneLaneLinkFlags Flags = SideFlag;
+				if (FVector::DotProduct(GetLaneTangentLambda(LaneIdx), GetLaneTangentLambda(AdjacentLaneIdx)) < 0.0)
+					Flags |= EZoneLaneLinkFlags::OppositeDirection;
+				Storage.LaneLinks.Add(FZoneLaneLinkData(AdjacentLaneIdx, EZoneLaneLinkType::Adjacent, Flags));
+			};
+
+		AddAdjacentLambda(LeftLanes, EZoneLaneLinkFlags::Left);
+		AddAdjacentLambda(RightLanes, EZoneLaneLinkFlags::Right);
+
+		Lane.LinksEnd = Storage.LaneLinks.Num();
+	}
+
+	// -------- Entry ids, all the lane starts and ends that meet at a junction should share one entry id --------
+	// Union-find over the starts (LocalLaneIdx * 2) and ends (LocalLaneIdx * 2 + 1), as several lanes may merge into or split from one
+	const int32 NumNewLanes = Storage.Lanes.Num() - LaneStartIdx;
+	TArray<int32> EntryParents;
+	EntryParents.SetNumUninitialized(NumNewLanes * 2);
+	for (int32 EntryIdx = 0; EntryIdx < EntryParents.Num(); ++EntryIdx)
+		EntryParents[EntryIdx] = EntryIdx;
+
+	auto FindEntryRootLambda = [&EntryParents](int32 EntryIdx)
+		{
+			while (EntryParents[EntryIdx] != EntryIdx)
+			{
+				EntryParents[EntryIdx] = EntryParents[EntryParents[EntryIdx]];  // Path halving
+				EntryIdx = EntryParents[EntryIdx];
+			}
+			return EntryIdx;
+		};
+
+	for (int32 CurveIdx = 0; CurveIdx < NumCurves; ++CurveIdx)  // Incomings are derived from outgoings, so outgoings cover all junctions
+	{
+		const int32& LaneIdx = CurveLaneIndices[CurveIdx];
+		if (LaneIdx == INDEX_NONE)
+			continue;
+
+		for (const int32& DestCurveIdx : CurveOutgoings[CurveIdx])
+		{
+			if (CurveLaneIndices[DestCurveIdx] != INDEX_NONE)
+				EntryParents[FindEntryRootLambda((LaneIdx - LaneStartIdx) * 2 + 1)] = FindEntryRootLambda((CurveLaneIndices[DestCurveIdx] - LaneStartIdx) * 2);
+		}
+	}
+
+	TArray<int32> RootEntryIds;
+	RootEntryIds.Init(INDEX_NONE, EntryParents.Num());
+	auto GetEntryIdLambda = [&](const int32& EntryIdx)
+		{
+			int32& EntryId = RootEntryIds[FindEntryRootLambda(EntryIdx)];
+			if (EntryId == INDEX_NONE)
+				EntryId = NextEntryId++;
+			return EntryId;
+		};
+
+	for (int32 LocalLaneIdx = 0; LocalLaneIdx < NumNewLanes; ++LocalLaneIdx)
+	{
+		FZoneLaneData& Lane = Storage.Lanes[LaneStartIdx + LocalLaneIdx];
+		Lane.StartEntryId = GetEntryIdLambda(LocalLaneIdx * 2);
+		Lane.EndEntryId = GetEntryIdLambda(LocalLaneIdx * 2 + 1);
+	}
+
+	return true;
+}
+
+using namespace HoudiniZoneGraphOutputUtils;
+
+bool UHoudiniOutputZoneGraph::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniOutputZoneGraph);
+
+	const int32& NodeId = GeoInfo.nodeId;
+
+	FZoneGraphStorage NewStorage;
+	for (const HAPI_PartInfo& PartInfo : PartInfos)
+		HOUDINI_FAIL_RETURN(HapiAppendLanes(NodeId, PartInfo, NewStorage));
+
+	NewStorage.Bounds.Init();
+	for (const FZoneData& Zone : NewStorage.Zones)
+		NewStorage.Bounds += Zone.Bounds;
+	NewStorage.ZoneBVTree.Build(MakeStridedView(NewStorage.Zones, &FZoneData::Bounds));
+
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_OutputCurves, NewStorage.Lanes.Num());
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_OutputPoints, NewStorage.LanePoints.Num());
+
+	FHoudiniEngine::Get().FinishHoudiniMainTaskMessage();  // Avoid RHI crash
+
+	Modify();  // Only ZoneGraphData is transacted, so that PostEditUndo could recapture it
+	Storage = MoveTemp(NewStorage);
+	StorageHash = GetStorageHash(Storage);
+	bStorageCaptured = true;
+	CommitStorage();
+
+	return true;
+}
+
+uint32 UHoudiniOutputZoneGraph::GetStorageHash(const FZoneGraphStorage& InStorage)
+{
+	uint32 Hash = 0;
+	auto HashArrayLambda = [&Hash](const auto& Array)
+		{
+			Hash = FCrc::MemCrc32(Array.GetData(), Array.Num() * Array.GetTypeSize(), HashCombineFast(Hash, GetTypeHash(Array.Num())));
+		};
+
+	HashArrayLambda(InStorage.Zones);
+	HashArrayLambda(InStorage.Lanes);
+	HashArrayLambda(InStorage.LanePoints);
+	HashArrayLambda(InStorage.LaneUpVectors);
+	HashArrayLambda(InStorage.LaneTangentVectors);
+	HashArrayLambda(InStorage.LanePointProgressions);
+	HashArrayLambda(InStorage.LaneLinks);
+	HashArrayLambda(InStorage.BoundaryPoints);
+	return Hash;
+}
+
+static const FName HoudiniZoneGraphDataTag(TEXT("HoudiniZoneGraph"));  // Mark zone graph data output by houdini
+
+static void WriteZoneGraphStorage(AZoneGraphData* ZGD, const FZoneGraphStorage& Storage)
+{
+	// Re-register, so that the zone graph subsystem will refresh its data handle and queries
+	UZoneGraphSubsystem* ZoneGraphSubsystem = UWorld::GetSubsystem<UZoneGraphSubsystem>(ZGD->GetWorld());
+	if (ZoneGraphSubsystem)
+		ZoneGraphSubsystem->UnregisterZoneGraphData(*ZGD);
+
+	{
+		FScopeLock Lock(&ZGD->GetStorageLock());
+		ZGD->GetStorageMutable() = Storage;
+	}
+
+	if (ZoneGraphSubsystem)
+		ZoneGraphSubsystem->RegisterZoneGraphData(*ZGD);
+
+	ZGD->UpdateDrawing();
+}
+
+void UHoudiniOutputZoneGraph::CommitStorage()
+{
+	AZoneGraphData* ZGD = ZoneGraphData.Get();
+	if (!IsValid(ZGD))
+	{
+		AHoudiniNode* Node = GetNode();
+		if (!IsValid(Node))
+			return;
+
+		ULevel* Level = Node->GetLevel();
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.OverrideLevel = Level;
+		SpawnParams.ObjectFlags = RF_Transactional;
+
+		// Zone shapes are built into every zone graph data of their level, so this one should NOT be the only one,
+		// otherwise lanes of zone shapes will be overwritten by the restore after build
+		bool bHasOtherZGD = false;
+		for (TActorIterator<AZoneGraphData> ZGDIter(Node->GetWorld()); ZGDIter; ++ZGDIter)
+		{
+			if (IsValid(*ZGDIter) && (ZGDIter->GetLevel() == Level) && !ZGDIter->Tags.Contains(HoudiniZoneGraphDataTag))
+			{
+				bHasOtherZGD = true;
+				break;
+			}
+		}
+		if (!bHasOtherZGD)
+			Node->GetWorld()->SpawnActor<AZoneGraphData>(SpawnParams);
+
+		ZGD = Node->GetWorld()->SpawnActor<AZoneGraphData>(SpawnParams);
+		if (!IsValid(ZGD))
+			return;
+
+		ZGD->SetActorLabel(Node->GetActorLabel() + TEXT("_ZoneGraph"));
+		ZoneGraphData = ZGD;
+	}
+	else if (GetStorageHash(ZGD->GetStorage()) == StorageHash)  // Unchanged, should NOT dirty the level
+		return;
+
+	ZGD->Modify();
+	ZGD->Tags.AddUnique(HoudiniZoneGraphDataTag);
+	WriteZoneGraphStorage(ZGD, Storage);
+}
+
+void UHoudiniOutputZoneGraph::CaptureStorage()
+{
+	if (bStorageCaptured)
+		return;
+
+	const AZoneGraphData* ZGD = ZoneGraphData.Get();
+	if (!IsValid(ZGD) || !ZGD->GetWorld() || ZGD->GetWorld()->IsGameWorld())  // Zone graph build only happens in editor worlds
+		return;
+
+	{
+		FScopeLock Lock(&ZGD->GetStorageLock());
+		Storage = ZGD->GetStorage();
+	}
+	StorageHash = GetStorageHash(Storage);
+	bStorageCaptured = true;
+}
+
+void UHoudiniOutputZoneGraph::RestoreStorage(const UWorld* BuiltWorld)
+{
+	if (!bStorageCaptured)
+		return;
+
+	AZoneGraphData* ZGD = ZoneGraphData.Get();
+	if (!IsValid(ZGD) || (ZGD->GetWorld() != BuiltWorld) || (GetStorageHash(ZGD->GetStorage()) == StorageHash))
+		return;
+
+	WriteZoneGraphStorage(ZGD, Storage);  // Restore what has been saved, so no Modify
+}
+
+void UHoudiniOutputZoneGraph::PostLoad()
+{
+	Super::PostLoad();
+
+	CaptureStorage();  // ZoneGraphData may load after, then will be captured when it is added to zone graph subsystem
+}
+
+#if WITH_EDITOR
+void UHoudiniOutputZoneGraph::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// ZoneGraphData has been undone in the same transaction
+	bStorageCaptured = false;
+	Storage = FZoneGraphStorage();
+	CaptureStorage();
+}
+#endif
+
+void UHoudiniOutputZoneGraph::Destroy() const
+{
+	if (AZoneGraphData* ZGD = ZoneGraphData.Get())
+		ZGD->Destroy();
+}
@@ -2,6 +2,10 @@
 
 #include "HoudiniOutputZoneShape.h"
 
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/NameAsStringProxyArchive.h"
 #include "ZoneGraphSettings.h"
 #include "ZoneShapeComponent.h"
 
@@ -13,7 +17,30 @@
 
 #include "HoudiniMassTranslator.h"
 #include "HoudiniMassCommon.h"
-
+#include "HoudiniMassConversion.h"
+#include "HoudiniLaneProfileRegistry.h"
+#include "HoudiniMassSettings.h"
+#include "HoudiniZoneGraphSettingsCache.h"
+#include "HoudiniZoneShapeSpatialIndex.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Output: Attribute Names"), STAT_HoudiniMass_OutputAttribNames, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Split Classification"), STAT_HoudiniMass_OutputSplit, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Positions and Rotations"), STAT_HoudiniMass_OutputTransforms, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Part Retrieval"), STAT_HoudiniMass_OutputRetrievePart, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Lane Profile Resolution"), STAT_HoudiniMass_OutputLaneProfiles, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Lane Json Parse"), STAT_HoudiniMass_OutputJsonParse, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Tag Resolution"), STAT_HoudiniMass_OutputTags, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: UProperty Attributes"), STAT_HoudiniMass_OutputPropAttribs, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Config Write"), STAT_HoudiniMass_OutputConfigWrite, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Build Points"), STAT_HoudiniMass_OutputBuildPoints, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Component Create and Update"), STAT_HoudiniMass_OutputApply, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: Destroy Old Components"), STAT_HoudiniMass_OutputDestroy, STATGROUP_HoudiniMass);
+DECLARE_CYCLE_STAT(TEXT("Output: UpdateShape"), STAT_HoudiniMass_OutputUpdateShape, STATGROUP_HoudiniMass);
+
+static TAutoConsoleVariable<bool> CVarCaptureZoneShapeOutput(
+	TEXT("HoudiniMass.CaptureZoneShapeOutput"), false,
+	TEXT("Save the decoded parts of each zone shape output to Saved/HoudiniMass/, replay them by HoudiniMass.ReplayZoneShapeOutput <File>"));
 
 bool FHoudiniZoneShapeOutputBuilder::HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput)
 {
@@ -25,14 +52,14 @@ bool FHoudiniZoneShapeOutputBuilder::HapiIsPartValid(const int32& NodeId, const
 		const int32& PartId = PartInfo.id;
 
 		HAPI_AttributeInfo AttribInfo;
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
 			HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_SHAPE, HAPI_ATTROWNER_DETAIL, &AttribInfo));
 
 		if (AttribInfo.exists && !FHoudiniEngineUtils::IsArray(AttribInfo.storage) &&
 			FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) == EHoudiniStorageType::Int)  // Currently only support i@unreal_output_zone_shape = 1 on detail
 		{
 			int bIsZoneShape = 0;
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
 				HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_SHAPE, &AttribInfo, 1, &bIsZoneShape, 0, 1));
 
 			bOutIsValid = bool(bIsZoneShape);
@@ -62,109 +89,222 @@ void FHoudiniZoneShapeOutput::Destroy(const AHoudiniNode* Node) const
 
 namespace HoudiniZoneShapeOutputUtils
 {
-	static FZoneGraphTagMask FindOrCreateZoneGraphTag(UZoneGraphSettings* ZoneGraphSettings, const FName& TagName, bool& bZoneGraphSettingsModified);
-
-	static bool HapiGetOrCreateTags(const int32& NodeId, const int32& PartId, UZoneGraphSettings* ZoneGraphSettings,
-		HAPI_AttributeOwner& InOutOwner, TArray<FZoneGraphTagMask>& OutTags, bool& bZoneGraphSettingsModified);
+	FORCEINLINE static bool IsIntStorage(const HAPI_StorageType& Storage)
+	{
+		return (Storage == HAPI_STORAGETYPE_INT) || (Storage == HAPI_STORAGETYPE_INT64) ||
+			(Storage == HAPI_STORAGETYPE_INT16) || (Storage == HAPI_STORAGETYPE_INT8) || (Storage == HAPI_STORAGETYPE_UINT8);
+	}
 
-	FORCEINLINE static uint32 GetLaneProfileHash(const TArray<FZoneLaneDesc>& Lanes)
+	FORCEINLINE static bool IsFloatStorage(const HAPI_StorageType& Storage)
 	{
-		return GetTypeHash(TArray<uint8>((uint8*)Lanes.GetData(), Lanes.GetTypeSize() * Lanes.Num()));
+		return (Storage == HAPI_STORAGETYPE_FLOAT) || (Storage == HAPI_STORAGETYPE_FLOAT64);
 	}
 
+	static bool HapiGetIntAttributeData(const int32& NodeId, const int32& PartId, const char* AttribName,
+		HAPI_AttributeOwner& InOutOwner, TArray<int32>& OutData);
+
+	struct FZoneShapeTagData  // Decoded s@unreal_zone_shape_tags, tags will be found or created on game thread
+	{
+		TArray<FName> TagNames;  // Unique
+		TArray<int32> Counts;  // Only for string array
+		TArray<int32> TagIndices;  // Indices of TagNames, per elem for string, per array elem for string array
+
+		void Resolve(UZoneGraphSettings* ZoneGraphSettings, FHoudiniZoneGraphSettingsCache& SettingsCache,
+			TArray<FZoneGraphTagMask>& OutTags, bool& bZoneGraphSettingsModified) const;
+	};
+
+	static bool HapiGetTags(const int32& NodeId, const int32& PartId, HAPI_AttributeOwner& InOutOwner, FZoneShapeTagData& OutData);
+
 	static FString GetLaneProfileString(const TArray<FZoneLaneDesc>& Lanes);
 
-	static bool HapiGetOrCreateLaneProfiles(const int32& NodeId, const int32& PartId, UZoneGraphSettings* ZoneGraphSettings,
-		const HAPI_AttributeOwner& NameOwner, const HAPI_AttributeOwner& LanesOwner, TMap<uint32, int32>& InOutHashProfileIdxMap, TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified);
+	static void CollectLaneProfileIndices(const FHoudiniZoneShapePart& Part, const FHoudiniZoneShapeCurves& Curves, TSet<int32>& InOutLaneProfileIndices);
+
+	struct FZoneLaneProfileData  // Decoded lane profile attribs, lane profiles will be found or created on game thread
+	{
+		HAPI_AttributeOwner NameOwner = HAPI_ATTROWNER_INVALID;
+		TArray<FName> Names;
+
+		TArray<FZoneLaneDesc> Lanes;
+		TArray<TArray<FName>> LaneTagNames;  // Empty for numeric lanes, else the same num as Lanes, non-empty ones will replace the tags of lanes
+		TArray<int32> ProfileLaneOffsets;  // Per profile, ProfileLaneIndices[ProfileLaneOffsets[ProfileIdx]] is the first lane of a profile
+		TArray<int32> ProfileLaneIndices;  // Indices of Lanes
+		TArray<int32> ElemProfileIndices;  // INDEX_NONE means find lane profile by name
+
+		FORCEINLINE int32 AddProfile() { return ProfileLaneOffsets.Add(ProfileLaneIndices.Num()); }  // Then append lane indices of this profile
+
+		FORCEINLINE int32 GetProfileLaneEnd(const int32& ProfileIdx) const
+		{
+			return ProfileLaneOffsets.IsValidIndex(ProfileIdx + 1) ? ProfileLaneOffsets[ProfileIdx + 1] : ProfileLaneIndices.Num();
+		}
+
+		void Resolve(UZoneGraphSettings* ZoneGraphSettings, FHoudiniZoneGraphSettingsCache& SettingsCache,
+			TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified) const;
+	};
+
+	static bool HapiGetLaneProfiles(const int32& NodeId, const int32& PartId,
+		const HAPI_AttributeOwner& NameOwner, const HAPI_AttributeOwner& LanesOwner, const bool& bNumericLanes, FZoneLaneProfileData& OutData);
+
+	static bool HapiGetLaneProfiles(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
+		const bool bIsOnPoints, HAPI_AttributeOwner& OutLaneProfileOwner, FZoneLaneProfileData& OutData);
+
+	// Retrieve f@unreal_zone_shape_grid_size on detail, if > 0, classify curves by the cell of their bounds center, and retrieve positions
+	static bool HapiGetGridCells(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const HAPI_PartInfo& PartInfo,
+		const TArray<int32>& CurveCounts, TArray<float>& OutPositionData, TArray<int32>& OutSplitKeys, TArray<FString>& OutCellSplitValues);
+
+	// Compile the vertex and point unreal_uproperty_* attribs that could be set directly, data will be retrieved by HapiGetPointPropertySetterData
+	static void CompilePointPropertySetters(const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
+		TArray<FHoudiniZoneShapePointPropertySetter>& OutSetters, TArray<int32>& OutAttribIndices);
+
+	static bool HapiGetPointPropertySetterData(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames,
+		const TArray<int32>& AttribIndices, TArray<FHoudiniZoneShapePointPropertySetter>& InOutSetters);
+
+	struct FZoneShapePartSettingsData  // Decoded attribs of a part that should be resolved into UZoneGraphSettings
+	{
+		FZoneLaneProfileData PointLaneProfiles;
+		FZoneLaneProfileData LaneProfiles;
+		FZoneShapeTagData Tags;
+
+		TArray<int32> PointPropAttribIndices;  // Indices of Part.AttribNames, the same num as Part.PointPropSetters
+	};
+
+	// Find the owners of the bulk attribs, and compile point property setters
+	static void PrepareRetrievePartBuffers(FHoudiniZoneShapePart& Part, FZoneShapePartSettingsData& OutSettingsData);
+
+	// Retrieve the bulk numeric attribs of a part: positions, rotations, shape ids and point property setters
+	static bool HapiRetrievePartBuffers(const int32& NodeId, FHoudiniZoneShapePart& Part, const FZoneShapePartSettingsData& SettingsData);
+
+	// Retrieve and decode the rest attribs of a part by the helpers of Houdini Engine plugin
+	static bool HapiRetrievePart(const int32& NodeId, FHoudiniZoneShapePart& Part, FZoneShapePartSettingsData& InOutSettingsData);
+
+	static void CollectComponentProperties(FHoudiniZoneShapePart& Part, const TArray<std::string>& PropAttribNames);
 
-	static bool HapiGetOrCreateLaneProfiles(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
-		UZoneGraphSettings* ZoneGraphSettings, const bool bIsOnPoints,
-		HAPI_AttributeOwner& OutLaneProfileOwner, TMap<uint32, int32>& InOutHashProfileIdxMap, TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified);
+	class FZoneShapeComponentSnapshot  // Copies of what the output sets on a UZoneShapeComponent, used to judge whether the output changed it
+	{
+	public:
+		~FZoneShapeComponentSnapshot() { ResetProperties(); }
+
+		void Capture(const UZoneShapeComponent* ZSC, const TArray<const FProperty*>& Properties);  // Properties are those set by prim or detail uproperty attribs
+
+		bool Equals(const UZoneShapeComponent* ZSC) const;
+
+	protected:
+		TArray<FZoneShapePoint> Points;
+		FZoneShapeType ShapeType = FZoneShapeType::Spline;
+		FZoneGraphTagMask Tags;
+		FZoneLaneProfileRef CommonLaneProfile;
+		TArray<FZoneLaneProfileRef> PerPointLaneProfiles;
+
+		TArray<TPair<const FProperty*, void*>> PropertyValues;
+
+		void ResetProperties();
+	};
 }
 
-FZoneGraphTagMask HoudiniZoneShapeOutputUtils::FindOrCreateZoneGraphTag(UZoneGraphSettings* ZoneGraphSettings, const FName& TagName, bool& bZoneGraphSettingsModified)
+bool HoudiniZoneShapeOutputUtils::HapiGetIntAttributeData(const int32& NodeId, const int32& PartId, const char* AttribName,
+	HAPI_AttributeOwner& InOutOwner, TArray<int32>& OutData)
 {
-	TConstArrayView<FZoneGraphTagInfo> ConstTagInfos = ZoneGraphSettings->GetTagInfos();
-	TArrayView<FZoneGraphTagInfo> TagInfos = *((TArrayView<FZoneGraphTagInfo>*)&ConstTagInfos);
+	if (InOutOwner == HAPI_ATTROWNER_INVALID)
+		return true;
 
-	// First, try find the tag by name
-	const int32 FoundTagIdx = TagInfos.IndexOfByPredicate([&TagName](const FZoneGraphTagInfo& TagInfo) { return TagInfo.Name == TagName; });
-	if (TagInfos.IsValidIndex(FoundTagIdx))
-		return TagInfos[FoundTagIdx].Tag;
-	
-	// Second, try find tag that is invalid (name is none) and set name, as a created tag
-	for (FZoneGraphTagInfo& TagInfo : TagInfos)
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+		NodeId, PartId, AttribName, InOutOwner, &AttribInfo));
+
+	if (!AttribInfo.exists || (AttribInfo.tupleSize != 1) || !IsIntStorage(AttribInfo.storage))
 	{
-		if (!TagInfo.IsValid())
-		{
-			TagInfo.Name = TagName;
-			bZoneGraphSettingsModified = true;
-			return TagInfo.Tag;
-		}
+		InOutOwner = HAPI_ATTROWNER_INVALID;
+		return true;
 	}
 
-	UE_LOG(LogHoudiniEngine, Error, TEXT("Cannot create zone graph tag: %s"), *TagName.ToString());
-	return FZoneGraphTagMask(1);
+	OutData.SetNumUninitialized(AttribInfo.count);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		AttribName, &AttribInfo, 1, OutData.GetData(), 0, AttribInfo.count));
+
+	return true;
 }
 
-bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateTags(const int32& NodeId, const int32& PartId, UZoneGraphSettings* ZoneGraphSettings,
-	HAPI_AttributeOwner& InOutOwner, TArray<FZoneGraphTagMask>& OutTags, bool& bZoneGraphSettingsModified)
+bool HoudiniZoneShapeOutputUtils::HapiGetTags(const int32& NodeId, const int32& PartId, HAPI_AttributeOwner& InOutOwner, FZoneShapeTagData& OutData)
 {
 	if (InOutOwner == HAPI_ATTROWNER_INVALID)
 		return true;
 
+	SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputTags);
+
 	HAPI_AttributeInfo AttribInfo;
-	HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
 		NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, InOutOwner, &AttribInfo));
 
-	TArray<int32> Counts;
 	TArray<HAPI_StringHandle> SHs;
 	if (AttribInfo.storage == HAPI_STORAGETYPE_STRING)
 	{
 		SHs.SetNumUninitialized(AttribInfo.count);
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
 			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
 	}
 	else if (AttribInfo.storage == HAPI_STORAGETYPE_STRING_ARRAY)
 	{
-		Counts.SetNumUninitialized(AttribInfo.count);
+		OutData.Counts.SetNumUninitialized(AttribInfo.count);
 		SHs.SetNumUninitialized(AttribInfo.totalArrayElements);
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, &AttribInfo, SHs.GetData(), AttribInfo.totalArrayElements, Counts.GetData(), 0, AttribInfo.count));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeStringArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, &AttribInfo, SHs.GetData(), AttribInfo.totalArrayElements, OutData.Counts.GetData(), 0, AttribInfo.count));
 	}
 	else
+	{
+		InOutOwner = HAPI_ATTROWNER_INVALID;
 		return true;
+	}
 
-	TMap<HAPI_StringHandle, FZoneGraphTagMask> SHTagMap;
+	TMap<HAPI_StringHandle, int32> SHTagIdxMap;
 	{
 		TArray<HAPI_StringHandle> TagSHs = TSet<HAPI_StringHandle>(SHs).Array();
 		TArray<std::string> TagNames;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertStringHandles(TagSHs, TagNames));
+		HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertStringHandles(TagSHs, TagNames));
 		for (int32 TagIdx = 0; TagIdx < TagSHs.Num(); ++TagIdx)
-			SHTagMap.Add(TagSHs[TagIdx], TagNames[TagIdx].empty() ? FZoneGraphTagMask() : FindOrCreateZoneGraphTag(ZoneGraphSettings, TagNames[TagIdx].c_str(), bZoneGraphSettingsModified));
+		{
+			SHTagIdxMap.Add(TagSHs[TagIdx], TagIdx);
+			OutData.TagNames.Add(TagNames[TagIdx].empty() ? NAME_None : FName(TagNames[TagIdx].c_str()));
+		}
 	}
 
-	if (AttribInfo.storage == HAPI_STORAGETYPE_STRING)
+	OutData.TagIndices.SetNumUninitialized(SHs.Num());
+	for (int32 SHIdx = 0; SHIdx < SHs.Num(); ++SHIdx)
+		OutData.TagIndices[SHIdx] = SHTagIdxMap[SHs[SHIdx]];
+
+	return true;
+}
+
+void HoudiniZoneShapeOutputUtils::FZoneShapeTagData::Resolve(UZoneGraphSettings* ZoneGraphSettings, FHoudiniZoneGraphSettingsCache& SettingsCache,
+	TArray<FZoneGraphTagMask>& OutTags, bool& bZoneGraphSettingsModified) const
+{
+	if (TagIndices.IsEmpty() && Counts.IsEmpty())
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputTags);
+
+	TArray<FZoneGraphTagMask> TagMasks;
+	TagMasks.SetNumUninitialized(TagNames.Num());
+	for (int32 TagIdx = 0; TagIdx < TagNames.Num(); ++TagIdx)
+		TagMasks[TagIdx] = TagNames[TagIdx].IsNone() ? FZoneGraphTagMask() : SettingsCache.FindOrCreateTag(ZoneGraphSettings, TagNames[TagIdx], bZoneGraphSettingsModified);
+
+	if (Counts.IsEmpty())  // String
 	{
-		OutTags.SetNumUninitialized(AttribInfo.count);
-		for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-			OutTags[ElemIdx] = SHTagMap[SHs[ElemIdx]];
+		OutTags.SetNumUninitialized(TagIndices.Num());
+		for (int32 ElemIdx = 0; ElemIdx < TagIndices.Num(); ++ElemIdx)
+			OutTags[ElemIdx] = TagMasks[TagIndices[ElemIdx]];
 	}
-	else if (AttribInfo.storage == HAPI_STORAGETYPE_STRING_ARRAY)
+	else  // String array
 	{
-		OutTags.SetNum(AttribInfo.count);
+		OutTags.SetNum(Counts.Num());
 		int32 ArrayElemIdx = 0;
-		for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
+		for (int32 ElemIdx = 0; ElemIdx < Counts.Num(); ++ElemIdx)
 		{
 			for (int32 ArrayIdx = 0; ArrayIdx < Counts[ElemIdx]; ++ArrayIdx)
 			{
-				OutTags[ElemIdx].Add(SHTagMap[SHs[ArrayElemIdx]]);
+				OutTags[ElemIdx].Add(TagMasks[TagIndices[ArrayElemIdx]]);
 				++ArrayElemIdx;
 			}
 		}
 	}
-
-	return true;
 }
 
 FString HoudiniZoneShapeOutputUtils::GetLaneProfileString(const TArray<FZoneLaneDesc>& Lanes)
@@ -183,44 +323,68 @@ FString HoudiniZoneShapeOutputUtils::GetLaneProfileString(const TArray<FZoneLane
 	return ProfileStr;
 }
 
-bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeId, const int32& PartId, UZoneGraphSettings* ZoneGraphSettings,
-	const HAPI_AttributeOwner& NameOwner, const HAPI_AttributeOwner& LanesOwner, TMap<uint32, int32>& InOutHashProfileIdxMap, TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified)
+void HoudiniZoneShapeOutputUtils::CollectLaneProfileIndices(const FHoudiniZoneShapePart& Part, const FHoudiniZoneShapeCurves& Curves, TSet<int32>& InOutLaneProfileIndices)
+{
+	for (const int32& CurveIdx : Curves.CurveIndices)
+	{
+		const int32 StartVertexIdx = (CurveIdx == 0) ? 0 : Part.VertexIndices[CurveIdx - 1];
+		if (!Part.LaneProfileIndices.IsEmpty())
+		{
+			const int32& LaneProfileIdx = Part.LaneProfileIndices[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.LaneProfileOwner, StartVertexIdx, CurveIdx)];
+			if (LaneProfileIdx >= 0)
+				InOutLaneProfileIndices.Add(LaneProfileIdx);
+		}
+
+		if (!Part.PointLaneProfileIndices.IsEmpty())
+		{
+			for (int32 VertexIdx = StartVertexIdx; VertexIdx < Part.VertexIndices[CurveIdx]; ++VertexIdx)
+			{
+				if (Part.PointLaneProfileIndices[VertexIdx] >= 0)
+					InOutLaneProfileIndices.Add(Part.PointLaneProfileIndices[VertexIdx]);
+			}
+		}
+	}
+}
+
+bool HoudiniZoneShapeOutputUtils::HapiGetLaneProfiles(const int32& NodeId, const int32& PartId,
+	const HAPI_AttributeOwner& NameOwner, const HAPI_AttributeOwner& LanesOwner, const bool& bNumericLanes, FZoneLaneProfileData& OutData)
 {
 	HAPI_AttributeInfo AttribInfo;
 
-	TArray<FName> LaneProfileNames;
+	OutData.NameOwner = NameOwner;
 	if (NameOwner != HAPI_ATTROWNER_INVALID)
 	{
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
 			NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME, NameOwner, &AttribInfo));
 
 		if (AttribInfo.storage == HAPI_STORAGETYPE_STRING)  // If is string, then means this is the name of a lane profile name
 		{
 			TArray<HAPI_StringHandle> SHs;
 			SHs.SetNumUninitialized(AttribInfo.count);
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
 
 			TMap<HAPI_StringHandle, FName> SHNameMap;
 			{
 				TArray<HAPI_StringHandle> UniqueSHs = TSet<HAPI_StringHandle>(SHs).Array();
 				TArray<FString> UniqueNames;
-				HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(UniqueSHs, UniqueNames));
+				HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(UniqueSHs, UniqueNames));
 				for (int32 UniqueIdx = 0; UniqueIdx < UniqueSHs.Num(); ++UniqueIdx)
 					SHNameMap.Add(UniqueSHs[UniqueIdx], *UniqueNames[UniqueIdx]);
 			}
-			LaneProfileNames.SetNum(AttribInfo.count);
+			OutData.Names.SetNum(AttribInfo.count);
 			for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-				LaneProfileNames[ElemIdx] = SHNameMap[SHs[ElemIdx]];
+				OutData.Names[ElemIdx] = SHNameMap[SHs[ElemIdx]];
 		}
 	}
 
 	if (LanesOwner != HAPI_ATTROWNER_INVALID)
 	{
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
-			NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, LanesOwner, &AttribInfo));
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+			NodeId, PartId, bNumericLanes ? HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH : HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, LanesOwner, &AttribInfo));
 
-		auto ConvertJsonToLaneLambda = [&](const TSharedPtr<FJsonObject>& JsonLane, FZoneLaneDesc& Lane) -> void
+		// Tags will be found or created when resolve, so here we just collect tag names
+		auto ConvertJsonToLaneLambda = [](const TSharedPtr<FJsonObject>& JsonLane, FZoneLaneDesc& Lane, TArray<FName>& OutTagNames) -> void
 			{
 				float LaneWidth = 0.0;
 				if (JsonLane->TryGetNumberField(TEXT("Width"), LaneWidth))
@@ -244,103 +408,155 @@ bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeI
 				const TArray<TSharedPtr<FJsonValue>>* JsonTagNames;
 				if (JsonLane->TryGetArrayField(TEXT("Tags"), JsonTagNames))
 				{
-					Lane.Tags = FZoneGraphTagMask(0);
+					Lane.Tags = FZoneGraphTagMask(0);  // Will be the default tag if no valid tag names
 					for (const TSharedPtr<FJsonValue>& JsonTagName : *JsonTagNames)
 					{
 						FString TagName;
 						if (JsonTagName->TryGetString(TagName))
-							Lane.Tags.Add(FindOrCreateZoneGraphTag(ZoneGraphSettings, *TagName, bZoneGraphSettingsModified));
+							OutTagNames.Add(*TagName);
 					}
-					if (Lane.Tags == FZoneGraphTagMask(0))
-						Lane.Tags = FZoneGraphTagMask(1);
 				}
 				else
 				{
 					FString TagName;
 					if (JsonLane->TryGetStringField(TEXT("Tag"), TagName))
-						Lane.Tags = FindOrCreateZoneGraphTag(ZoneGraphSettings, *TagName, bZoneGraphSettingsModified);
+						OutTagNames.Add(*TagName);
 				}
 			};
 
-		auto FindOrAddLaneProfileLambda = [&](const int32& ElemIdx, const FName& LaneProfileName, const uint32& HashValue, const TArray<FZoneLaneDesc>& Lanes)
-			{
-				if (const int32* FoundProfileIdxPtr = InOutHashProfileIdxMap.Find(HashValue))
-					OutLaneProfileIndices[ElemIdx] = *FoundProfileIdxPtr;
-				else  // Create a new lane profile
+		if (bNumericLanes && ((AttribInfo.storage == HAPI_STORAGETYPE_FLOAT_ARRAY) || (AttribInfo.storage == HAPI_STORAGETYPE_FLOAT64_ARRAY)))
+		{
+			// f[]@unreal_zone_lane_width, i[]@unreal_zone_lane_direction, i[]@unreal_zone_lane_tags, no json parsing needed
+			TArray<int32> Counts;
+			Counts.SetNumUninitialized(AttribInfo.count);
+			TArray<float> Widths;
+			Widths.SetNumUninitialized(AttribInfo.totalArrayElements);
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, &AttribInfo, Widths.GetData(), AttribInfo.totalArrayElements, Counts.GetData(), 0, AttribInfo.count));
+
+			auto HapiGetLaneIntsLambda = [&](const char* AttribName, TArray<int32>& OutValues) -> bool
 				{
-					FZoneLaneProfile NewLaneProfile;
-					NewLaneProfile.Name = LaneProfileName.IsNone() ?
-						FName(HOUDINI_LANE_PROFILE_PREFIX + GetLaneProfileString(Lanes), FMath::Abs(int32(HashValue))) : LaneProfileName;
-					NewLaneProfile.Lanes = Lanes;
+					HAPI_AttributeInfo IntAttribInfo;
+					HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+						NodeId, PartId, AttribName, LanesOwner, &IntAttribInfo));
 
-					const int32 NewProfileIdx = ((TArray<FZoneLaneProfile>*) & ZoneGraphSettings->GetLaneProfiles())->Add(NewLaneProfile);
-					bZoneGraphSettingsModified = true;
+					if (!IntAttribInfo.exists)
+						return true;
 
-					InOutHashProfileIdxMap.Add(HashValue, NewProfileIdx);
-					OutLaneProfileIndices[ElemIdx] = NewProfileIdx;
-				}
-			};
+					if ((IntAttribInfo.storage != HAPI_STORAGETYPE_INT_ARRAY) || (IntAttribInfo.totalArrayElements != AttribInfo.totalArrayElements))
+					{
+						UE_LOG(LogHoudiniEngine, Warning, TEXT("%s should be an int array that has the same count as %s, ignored"),
+							UTF8_TO_TCHAR(AttribName), TEXT(HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH));
+						return true;
+					}
+
+					TArray<int32> IntCounts;
+					IntCounts.SetNumUninitialized(IntAttribInfo.count);
+					OutValues.SetNumUninitialized(IntAttribInfo.totalArrayElements);
+					HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+						AttribName, &IntAttribInfo, OutValues.GetData(), IntAttribInfo.totalArrayElements, IntCounts.GetData(), 0, IntAttribInfo.count));
+
+					if (IntCounts != Counts)  // Lanes must match with widths one by one
+					{
+						UE_LOG(LogHoudiniEngine, Warning, TEXT("%s should have the same count as %s on each element, ignored"),
+							UTF8_TO_TCHAR(AttribName), TEXT(HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH));
+						OutValues.Empty();
+					}
+
+					return true;
+				};
+
+			TArray<int32> Directions;
+			HOUDINI_FAIL_RETURN(HapiGetLaneIntsLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_DIRECTION, Directions));
+			TArray<int32> TagMasks;
+			HOUDINI_FAIL_RETURN(HapiGetLaneIntsLambda(HAPI_ATTRIB_UNREAL_ZONE_LANE_TAGS, TagMasks));
+
+			OutData.Lanes.SetNum(AttribInfo.totalArrayElements);
+			for (int32 ArrayIdx = 0; ArrayIdx < AttribInfo.totalArrayElements; ++ArrayIdx)
+			{
+				FZoneLaneDesc& Lane = OutData.Lanes[ArrayIdx];
+				Lane.Width = Widths[ArrayIdx] * POSITION_SCALE_TO_UNREAL_F;
+				if (!Directions.IsEmpty())
+					Lane.Direction = EZoneLaneDirection(FMath::Clamp(Directions[ArrayIdx], 0, 2));
+				if (!TagMasks.IsEmpty())
+					Lane.Tags = FZoneGraphTagMask(uint32(TagMasks[ArrayIdx]));
+			}
 
-		if (AttribInfo.storage == HAPI_STORAGETYPE_DICTIONARY_ARRAY)  // Means we should find or create a lane profile
+			// Each elem has its own lanes
+			OutData.ElemProfileIndices.SetNumUninitialized(AttribInfo.count);
+			OutData.ProfileLaneIndices.SetNumUninitialized(AttribInfo.totalArrayElements);
+			int32 AccumulatedCount = 0;
+			for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
+			{
+				const int32& Count = Counts[ElemIdx];
+				OutData.ElemProfileIndices[ElemIdx] = (Count <= 0) ? INDEX_NONE : OutData.ProfileLaneOffsets.Add(AccumulatedCount);  // Fallback to try to find lane profile by name
+				for (int32 ArrayIdx = AccumulatedCount; ArrayIdx < AccumulatedCount + Count; ++ArrayIdx)
+					OutData.ProfileLaneIndices[ArrayIdx] = ArrayIdx;
+				AccumulatedCount += FMath::Max(Count, 0);
+			}
+		}
+		else if (AttribInfo.storage == HAPI_STORAGETYPE_DICTIONARY_ARRAY)  // Means we should find or create a lane profile
 		{
 			TArray<int32> Counts;
 			Counts.SetNumUninitialized(AttribInfo.count);
 			TArray<HAPI_StringHandle> SHs;
 			SHs.SetNumUninitialized(AttribInfo.totalArrayElements);
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeDictionaryArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeDictionaryArrayData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, &AttribInfo, SHs.GetData(), AttribInfo.totalArrayElements, Counts.GetData(), 0, AttribInfo.count));
 
 			// HAPI BUG: GetAttributeDictionaryArrayData will get all sh unique, we could only find unique strs in unreal
 			TArray<FString> LaneDictStrs;
-			HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(SHs, LaneDictStrs));
-			TMap<FString, FZoneLaneDesc> SHLaneMap;
-			for (int32 ArrayIdx = 0; ArrayIdx < SHs.Num(); ++ArrayIdx)
+			HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(SHs, LaneDictStrs));
+			TMap<FString, int32> StrLaneIdxMap;
 			{
-				if (SHLaneMap.Contains(LaneDictStrs[ArrayIdx]))
-					continue;
+				SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputJsonParse);
+				for (const FString& LaneDictStr : LaneDictStrs)
+				{
+					if (StrLaneIdxMap.Contains(LaneDictStr))
+						continue;
 
-				FZoneLaneDesc Lane = FZoneLaneDesc();
-				TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(LaneDictStrs[ArrayIdx]);
-				TSharedPtr<FJsonObject> JsonLane;
-				if (FJsonSerializer::Deserialize(JsonReader, JsonLane))
-					ConvertJsonToLaneLambda(JsonLane, Lane);
+					FZoneLaneDesc& Lane = OutData.Lanes.Add_GetRef(FZoneLaneDesc());
+					TArray<FName>& TagNames = OutData.LaneTagNames.AddDefaulted_GetRef();
+					TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(LaneDictStr);
+					TSharedPtr<FJsonObject> JsonLane;
+					if (FJsonSerializer::Deserialize(JsonReader, JsonLane))
+						ConvertJsonToLaneLambda(JsonLane, Lane, TagNames);
 
-				SHLaneMap.Add(LaneDictStrs[ArrayIdx], Lane);
+					StrLaneIdxMap.Add(LaneDictStr, OutData.Lanes.Num() - 1);
+				}
+				INC_DWORD_STAT_BY(STAT_HoudiniMass_UniqueLanes, StrLaneIdxMap.Num());
 			}
 
-			OutLaneProfileIndices.SetNumUninitialized(AttribInfo.count);
+			OutData.ElemProfileIndices.SetNumUninitialized(AttribInfo.count);
 			int32 AccumulatedCount = 0;
 			for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
 			{
-				const FName LaneProfileName = LaneProfileNames.IsEmpty() ? NAME_None : LaneProfileNames[NameOwner == HAPI_ATTROWNER_DETAIL ? 0 : ElemIdx];
 				const int32& Count = Counts[ElemIdx];
 				if (Count <= 0)  // Fallback to try to find lane profile by name
 				{
-					OutLaneProfileIndices[ElemIdx] = LaneProfileNames.IsEmpty() ? -1 : ZoneGraphSettings->GetLaneProfiles().IndexOfByPredicate(
-						[LaneProfileName](const FZoneLaneProfile& LaneProfile) { return LaneProfile.Name == LaneProfileName; });
+					OutData.ElemProfileIndices[ElemIdx] = INDEX_NONE;
 					continue;
 				}
 
-				TArray<FZoneLaneDesc> Lanes;
+				OutData.ElemProfileIndices[ElemIdx] = OutData.AddProfile();
 				for (int32 ArrayIdx = AccumulatedCount; ArrayIdx < AccumulatedCount + Count; ++ArrayIdx)
-					Lanes.Add(SHLaneMap[LaneDictStrs[ArrayIdx]]);
+					OutData.ProfileLaneIndices.Add(StrLaneIdxMap[LaneDictStrs[ArrayIdx]]);
 				AccumulatedCount += Count;
-
-				FindOrAddLaneProfileLambda(ElemIdx, LaneProfileName, GetLaneProfileHash(Lanes), Lanes);
 			}
 		}
 		else if (AttribInfo.storage == HAPI_STORAGETYPE_STRING)  // Warning: Temporarily, will remove this method if HAPI fix the bug
 		{
 			TArray<HAPI_StringHandle> SHs;
 			SHs.SetNumUninitialized(AttribInfo.count);
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeStringData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
 				HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, &AttribInfo, SHs.GetData(), 0, AttribInfo.count));
 
-			TMap<HAPI_StringHandle, TPair<uint32, TArray<FZoneLaneDesc>>> SHLanesMap;
+			TMap<HAPI_StringHandle, int32> SHProfileIdxMap;
 			{
+				SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputJsonParse);
 				TArray<HAPI_StringHandle> UniqueSHs = TSet<HAPI_StringHandle>(SHs).Array();
 				TArray<FString> UniqueStrs;
-				HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(UniqueSHs, UniqueStrs));
+				HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiConvertUniqueStringHandles(UniqueSHs, UniqueStrs));
 				for (int32 UniqueIdx = 0; UniqueIdx < UniqueSHs.Num(); ++UniqueIdx)
 				{
 					if (UniqueStrs[UniqueIdx].IsEmpty())
@@ -353,68 +569,103 @@ bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeI
 						const TArray<TSharedPtr<FJsonValue>>* JsonLanesPtr = nullptr;
 						if (JsonLanes->TryGetArrayField(TEXT("Lanes"), JsonLanesPtr))
 						{
-							TArray<FZoneLaneDesc> Lanes;
+							SHProfileIdxMap.Add(UniqueSHs[UniqueIdx], OutData.AddProfile());
 							for (const TSharedPtr<FJsonValue>& JsonLane : *JsonLanesPtr)
 							{
 								const TSharedPtr<FJsonObject>* JsonLanePtr = nullptr;
-								FZoneLaneDesc Lane = FZoneLaneDesc();
+								FZoneLaneDesc& Lane = OutData.Lanes.Add_GetRef(FZoneLaneDesc());
+								TArray<FName>& TagNames = OutData.LaneTagNames.AddDefaulted_GetRef();
 								if (JsonLane->TryGetObject(JsonLanePtr))
-									ConvertJsonToLaneLambda(*JsonLanePtr, Lane);
-								Lanes.Add(Lane);
+									ConvertJsonToLaneLambda(*JsonLanePtr, Lane, TagNames);
+								OutData.ProfileLaneIndices.Add(OutData.Lanes.Num() - 1);
 							}
-							SHLanesMap.Add(UniqueSHs[UniqueIdx], TPair<uint32, TArray<FZoneLaneDesc>>(GetLaneProfileHash(Lanes), Lanes));
 						}
 					}
 				}
 			}
-			OutLaneProfileIndices.SetNumUninitialized(AttribInfo.count);
+
+			OutData.ElemProfileIndices.SetNumUninitialized(AttribInfo.count);
 			for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
 			{
-				const FName LaneProfileName = LaneProfileNames.IsEmpty() ? NAME_None : LaneProfileNames[NameOwner == HAPI_ATTROWNER_DETAIL ? 0 : ElemIdx];
-				const TPair<uint32, TArray<FZoneLaneDesc>>* HashLanesPtr = SHLanesMap.Find(SHs[ElemIdx]);
-				if (!HashLanesPtr)  // Fallback to try to find lane profile by name
-				{
-					OutLaneProfileIndices[ElemIdx] = LaneProfileNames.IsEmpty() ? -1 : ZoneGraphSettings->GetLaneProfiles().IndexOfByPredicate(
-						[LaneProfileName](const FZoneLaneProfile& LaneProfile) { return LaneProfile.Name == LaneProfileName; });
-					continue;
-				}
-
-				FindOrAddLaneProfileLambda(ElemIdx, LaneProfileName, HashLanesPtr->Key, HashLanesPtr->Value);
+				const int32* FoundProfileIdxPtr = SHProfileIdxMap.Find(SHs[ElemIdx]);
+				OutData.ElemProfileIndices[ElemIdx] = FoundProfileIdxPtr ? *FoundProfileIdxPtr : INDEX_NONE;  // Fallback to try to find lane profile by name
 			}
 		}
 	}
 
-	if (OutLaneProfileIndices.IsEmpty() && !LaneProfileNames.IsEmpty())  // Fallback to try to find lane profile by name
+	return true;
+}
+
+void HoudiniZoneShapeOutputUtils::FZoneLaneProfileData::Resolve(UZoneGraphSettings* ZoneGraphSettings, FHoudiniZoneGraphSettingsCache& SettingsCache,
+	TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified) const
+{
+	if (ElemProfileIndices.IsEmpty())
 	{
-		OutLaneProfileIndices.SetNumUninitialized(LaneProfileNames.Num());
-		TMap<FName, int32> NameIdxMap;
-		for (int32 ElemIdx = 0; ElemIdx < LaneProfileNames.Num(); ++ElemIdx)
+		if (!Names.IsEmpty())  // Fallback to try to find lane profile by name
 		{
-			const FName LaneProfileName = LaneProfileNames[ElemIdx];
-			if (LaneProfileName.IsNone())
-			{
-				OutLaneProfileIndices[ElemIdx] = -1;
-				continue;
-			}
+			OutLaneProfileIndices.SetNumUninitialized(Names.Num());
+			for (int32 ElemIdx = 0; ElemIdx < Names.Num(); ++ElemIdx)
+				OutLaneProfileIndices[ElemIdx] = SettingsCache.FindLaneProfileByName(ZoneGraphSettings, Names[ElemIdx]);
+		}
+		return;
+	}
 
-			if (const int32* IdxPtr = NameIdxMap.Find(LaneProfileName))
-				OutLaneProfileIndices[ElemIdx] = *IdxPtr;
-			else
+	// Tags of lanes should be found or created first, as they are part of lane hashes
+	TArray<FZoneLaneDesc> ResolvedLanes = Lanes;
+	for (int32 LaneIdx = 0; LaneIdx < ResolvedLanes.Num(); ++LaneIdx)
+	{
+		FZoneLaneDesc& Lane = ResolvedLanes[LaneIdx];
+		if (LaneTagNames.IsValidIndex(LaneIdx) && !LaneTagNames[LaneIdx].IsEmpty())
+		{
+			Lane.Tags = FZoneGraphTagMask(0);
+			for (const FName& TagName : LaneTagNames[LaneIdx])
+				Lane.Tags.Add(SettingsCache.FindOrCreateTag(ZoneGraphSettings, TagName, bZoneGraphSettingsModified));
+		}
+		FHoudiniZoneGraphSettingsCache::CanonicalizeLane(Lane);
+	}
+
+	TArray<int32> ProfileIndices;  // Profile data idx -> UZoneGraphSettings lane profile idx, resolved by the first elem that refs it
+	ProfileIndices.Init(INDEX_NONE, ProfileLaneOffsets.Num());
+	OutLaneProfileIndices.SetNumUninitialized(ElemProfileIndices.Num());
+	TArray<FZoneLaneDesc> ProfileLanes;
+	for (int32 ElemIdx = 0; ElemIdx < ElemProfileIndices.Num(); ++ElemIdx)
+	{
+		const FName LaneProfileName = Names.IsEmpty() ? NAME_None : Names[NameOwner == HAPI_ATTROWNER_DETAIL ? 0 : ElemIdx];
+		const int32& ProfileIdx = ElemProfileIndices[ElemIdx];
+		if (ProfileIdx < 0)  // Fallback to try to find lane profile by name
+		{
+			OutLaneProfileIndices[ElemIdx] = SettingsCache.FindLaneProfileByName(ZoneGraphSettings, LaneProfileName);
+			continue;
+		}
+
+		int32& LaneProfileIdx = ProfileIndices[ProfileIdx];
+		if (LaneProfileIdx < 0)
+		{
+			ProfileLanes.Reset();
+			for (int32 Idx = ProfileLaneOffsets[ProfileIdx]; Idx < GetProfileLaneEnd(ProfileIdx); ++Idx)
+				ProfileLanes.Add(ResolvedLanes[ProfileLaneIndices[Idx]]);
+
+			const uint32 HashValue = FHoudiniZoneGraphSettingsCache::GetLaneProfileHash(ProfileLanes);
+			LaneProfileIdx = SettingsCache.FindLaneProfile(ZoneGraphSettings, ProfileLanes, HashValue);
+			if (LaneProfileIdx < 0)  // Create a new lane profile
 			{
-				const int32 Idx = ZoneGraphSettings->GetLaneProfiles().IndexOfByPredicate(
-					[LaneProfileName](const FZoneLaneProfile& LaneProfile) { return LaneProfile.Name == LaneProfileName; });
-				NameIdxMap.Add(LaneProfileName, Idx);
-				OutLaneProfileIndices[ElemIdx] = Idx;
+				FZoneLaneProfile NewLaneProfile;
+				NewLaneProfile.Name = LaneProfileName.IsNone() ?
+					FName(HOUDINI_LANE_PROFILE_PREFIX + GetLaneProfileString(ProfileLanes), FMath::Abs(int32(HashValue))) : LaneProfileName;
+				NewLaneProfile.Lanes = ProfileLanes;
+
+				LaneProfileIdx = SettingsCache.AddLaneProfile(ZoneGraphSettings, NewLaneProfile);
+				bZoneGraphSettingsModified = true;
+				INC_DWORD_STAT(STAT_HoudiniMass_LaneProfilesCreated);
 			}
 		}
-	}
 
-	return true;
+		OutLaneProfileIndices[ElemIdx] = LaneProfileIdx;
+	}
 }
 
-bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
-	UZoneGraphSettings* ZoneGraphSettings, const bool bIsOnPoints,
-	HAPI_AttributeOwner& OutLaneProfileOwner, TMap<uint32, int32>& InOutHashProfileIdxMap, TArray<int32>& OutLaneProfileIndices, bool& bZoneGraphSettingsModified)
+bool HoudiniZoneShapeOutputUtils::HapiGetLaneProfiles(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
+	const bool bIsOnPoints, HAPI_AttributeOwner& OutLaneProfileOwner, FZoneLaneProfileData& OutData)
 {
 	OutLaneProfileOwner = HAPI_ATTROWNER_INVALID;
 
@@ -429,17 +680,43 @@ bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeI
 		HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME, Owner1))
 		LaneProfileNameOwner = Owner1;
 
+	// Prefer the numeric lane encoding, as it can be retrieved in bulk and needs no json parsing
+	HAPI_AttributeOwner LaneWidthOwner = HAPI_ATTROWNER_INVALID;
 	if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, AttribCounts,
-		HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, Owner0))
-		OutLaneProfileOwner = Owner0;
+		HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, Owner0))
+		LaneWidthOwner = Owner0;
 	else if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, AttribCounts,
-		HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, Owner1))
-		OutLaneProfileOwner = Owner1;
+		HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, Owner1))
+		LaneWidthOwner = Owner1;
+
+	bool bNumericLanes = false;
+	if (LaneWidthOwner != HAPI_ATTROWNER_INVALID)
+	{
+		HAPI_AttributeInfo AttribInfo;
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(),
+			NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH, LaneWidthOwner, &AttribInfo));
+
+		bNumericLanes = (AttribInfo.storage == HAPI_STORAGETYPE_FLOAT_ARRAY) || (AttribInfo.storage == HAPI_STORAGETYPE_FLOAT64_ARRAY);
+		if (bNumericLanes)
+			OutLaneProfileOwner = LaneWidthOwner;
+		else
+			UE_LOG(LogHoudiniEngine, Warning, TEXT("%s should be a float array, fallback to %s"),
+				TEXT(HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH), TEXT(HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE));
+	}
+
+	if (!bNumericLanes)
+	{
+		if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, AttribCounts,
+			HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, Owner0))
+			OutLaneProfileOwner = Owner0;
+		else if (FHoudiniEngineUtils::IsAttributeExists(AttribNames, AttribCounts,
+			HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE, Owner1))
+			OutLaneProfileOwner = Owner1;
+	}
 
 	if ((LaneProfileNameOwner != HAPI_ATTROWNER_INVALID) || (OutLaneProfileOwner != HAPI_ATTROWNER_INVALID))
 	{
-		HOUDINI_FAIL_RETURN(HapiGetOrCreateLaneProfiles(NodeId, PartId,
-			ZoneGraphSettings, LaneProfileNameOwner, OutLaneProfileOwner, InOutHashProfileIdxMap, OutLaneProfileIndices, bZoneGraphSettingsModified));
+		HOUDINI_FAIL_RETURN(HapiGetLaneProfiles(NodeId, PartId, LaneProfileNameOwner, OutLaneProfileOwner, bNumericLanes, OutData));
 
 		if (OutLaneProfileOwner == HAPI_ATTROWNER_INVALID)
 			OutLaneProfileOwner = LaneProfileNameOwner;
@@ -448,110 +725,728 @@ bool HoudiniZoneShapeOutputUtils::HapiGetOrCreateLaneProfiles(const int32& NodeI
 	return true;
 }
 
-using namespace HoudiniZoneShapeOutputUtils;
+bool HoudiniZoneShapeOutputUtils::HapiGetGridCells(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames, const HAPI_PartInfo& PartInfo,
+	const TArray<int32>& CurveCounts, TArray<float>& OutPositionData, TArray<int32>& OutSplitKeys, TArray<FString>& OutCellSplitValues)
+{
+	if (!FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_GRID_SIZE, HAPI_ATTROWNER_DETAIL))
+		return true;
 
+	HAPI_AttributeInfo AttribInfo;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_ZONE_SHAPE_GRID_SIZE, HAPI_ATTROWNER_DETAIL, &AttribInfo));
+	if (FHoudiniEngineUtils::IsArray(AttribInfo.storage) || (FHoudiniEngineUtils::ConvertStorageType(AttribInfo.storage) != EHoudiniStorageType::Float))
+		return true;
 
-bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos)
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniOutputZoneShape);
+	float GridSize = 0.0f;
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_ZONE_SHAPE_GRID_SIZE, &AttribInfo, 1, &GridSize, 0, 1));
+	if (GridSize <= 0.0f)
+		return true;
 
-	const AHoudiniNode* Node = GetNode();
+	OutPositionData.SetNumUninitialized(PartInfo.pointCount * 3);
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
 
+	HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+		HAPI_ATTRIB_POSITION, &AttribInfo, -1, OutPositionData.GetData(), 0, PartInfo.pointCount));
 
-	struct FHoudiniCurveIndicesHolder
+	// Cell is computed in houdini space, houdini XZ is unreal XY, so the cell split values are stable whatever the unit scale is
+	TMap<FIntPoint, int32> CellKeyMap;
+	OutSplitKeys.SetNumUninitialized(PartInfo.faceCount);
+	int32 VertexIdx = 0;
+	for (int32 CurveIdx = 0; CurveIdx < PartInfo.faceCount; ++CurveIdx)
 	{
-		FHoudiniCurveIndicesHolder(const int8& UpdateMode, const FString& InSplitValue) :
-			PartialOutputMode(UpdateMode), SplitValue(InSplitValue) {}
+		FVector2f Min(FLT_MAX, FLT_MAX);
+		FVector2f Max(-FLT_MAX, -FLT_MAX);
+		for (int32 PointIdx = VertexIdx; PointIdx < VertexIdx + CurveCounts[CurveIdx]; ++PointIdx)
+		{
+			const FVector2f Pos(OutPositionData[PointIdx * 3], OutPositionData[PointIdx * 3 + 2]);
+			Min = FVector2f::Min(Min, Pos);
+			Max = FVector2f::Max(Max, Pos);
+		}
+		VertexIdx += CurveCounts[CurveIdx];
 
-		int8 PartialOutputMode = 0;
-		FString SplitValue;
+		const FVector2f Center = (CurveCounts[CurveIdx] >= 1) ? (Min + Max) * 0.5f : FVector2f::ZeroVector;
+		const FIntPoint Cell(FMath::FloorToInt32(Center.X / GridSize), FMath::FloorToInt32(Center.Y / GridSize));
+		int32& SplitKey = CellKeyMap.FindOrAdd(Cell, INDEX_NONE);
+		if (SplitKey == INDEX_NONE)
+		{
+			SplitKey = OutCellSplitValues.Num();
+			OutCellSplitValues.Add(FString::Printf(TEXT("Cell_%d_%d"), Cell.X, Cell.Y));
+		}
+		OutSplitKeys[CurveIdx] = SplitKey;
+	}
 
-		TArray<int32> CurveIndices;
-	};
+	return true;
+}
 
-	struct FHoudiniCurvesPart
+bool FHoudiniZoneShapePointPropertySetter::Init(const FName& PropertyName)
+{
+	Property = FZoneShapePoint::StaticStruct()->FindPropertyByName(PropertyName);
+	if (!Property || (Property->ArrayDim != 1) ||
+		(Property->GetFName() == GET_MEMBER_NAME_CHECKED(FZoneShapePoint, LaneProfile)))  // LaneProfile will be remapped on game thread, so leave it to FHoudiniAttribute
+		return false;
+
+	Offset = Property->GetOffset_ForInternal();
+	NumericProperty = nullptr;
+	if (Property->IsA<FFloatProperty>())
+		Type = EType::Float;
+	else if (Property->IsA<FDoubleProperty>())
+		Type = EType::Double;
+	else if (Property->IsA<FIntProperty>())
+		Type = EType::Int32;
+	else if (Property->IsA<FByteProperty>())
+		Type = EType::UInt8;
+	else if (Property->IsA<FBoolProperty>())
+		Type = EType::Bool;
+	else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		Type = EType::Numeric;
+		NumericProperty = EnumProperty->GetUnderlyingProperty();
+	}
+	else if (const FNumericProperty* NumericProp = CastField<FNumericProperty>(Property))
 	{
-		FHoudiniCurvesPart(const HAPI_PartInfo& PartInfo) : Info(PartInfo) {}
+		Type = EType::Numeric;
+		NumericProperty = NumericProp;
+	}
 
-		HAPI_PartInfo Info;
-		TArray<std::string> AttribNames;
-		TArray<int32> VertexIndices;  // Accumulate append CurveCounts
-		TMap<int32, FHoudiniCurveIndicesHolder> SplitCurvesMap;
-	};
+	return (Type != EType::Numeric) || NumericProperty;
+}
 
+void FHoudiniZoneShapePointPropertySetter::Set(const TArrayView<FZoneShapePoint>& Points, const int32& StartVertexIdx) const
+{
+	const float* ValuePtr = Data.GetData() + StartVertexIdx;  // On curves, vertex index is the same as point index
+	switch (Type)
+	{
+	case EType::Float:
+		for (FZoneShapePoint& Point : Points)
+			*(float*)((uint8*)&Point + Offset) = *ValuePtr++;
+		break;
+	case EType::Double:
+		for (FZoneShapePoint& Point : Points)
+			*(double*)((uint8*)&Point + Offset) = *ValuePtr++;
+		break;
+	case EType::Int32:
+		for (FZoneShapePoint& Point : Points)
+			*(int32*)((uint8*)&Point + Offset) = FMath::RoundToInt32(*ValuePtr++);
+		break;
+	case EType::UInt8:
+		for (FZoneShapePoint& Point : Points)
+			*((uint8*)&Point + Offset) = uint8(FMath::Clamp(FMath::RoundToInt32(*ValuePtr++), 0, 255));
+		break;
+	case EType::Bool:
+	{
+		const FBoolProperty* BoolProperty = (const FBoolProperty*)Property;  // Maybe a bitfield
+		for (FZoneShapePoint& Point : Points)
+			BoolProperty->SetPropertyValue((uint8*)&Point + Offset, *ValuePtr++ >= 0.5f);
+	}
+	break;
+	case EType::Numeric:
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			for (FZoneShapePoint& Point : Points)
+				NumericProperty->SetFloatingPointPropertyValue((uint8*)&Point + Offset, double(*ValuePtr++));
+		}
+		else
+		{
+			for (FZoneShapePoint& Point : Points)
+				NumericProperty->SetIntPropertyValue((uint8*)&Point + Offset, FMath::RoundToInt64(*ValuePtr++));
+		}
+	}
+	break;
+	}
+}
 
-	const int32& NodeId = GeoInfo.nodeId;
+void HoudiniZoneShapeOutputUtils::CompilePointPropertySetters(const TArray<std::string>& AttribNames, const int AttribCounts[HAPI_ATTROWNER_MAX],
+	TArray<FHoudiniZoneShapePointPropertySetter>& OutSetters, TArray<int32>& OutAttribIndices)
+{
+	static const size_t PrefixLength = strlen(HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY);
+	int32 AttribIdx = 0;
+	for (int32 OwnerIdx = HAPI_ATTROWNER_VERTEX; OwnerIdx <= HAPI_ATTROWNER_POINT; ++OwnerIdx)  // Attribute names are sorted by owner, only vertex and point attributes are on points
+	{
+		const HAPI_AttributeOwner Owner = HAPI_AttributeOwner(OwnerIdx);
+		const int32 EndAttribIdx = AttribIdx + AttribCounts[Owner];
+		for (; AttribIdx < EndAttribIdx; ++AttribIdx)
+		{
+			const std::string& AttribName = AttribNames[AttribIdx];
+			if ((AttribName.length() <= PrefixLength) || (strncmp(AttribName.c_str(), HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY, PrefixLength) != 0))
+				continue;
 
+			FHoudiniZoneShapePointPropertySetter Setter;
+			if (!Setter.Init(UTF8_TO_TCHAR(AttribName.c_str() + PrefixLength)))
+				continue;
 
-	// -------- Retrieve all part data --------
-	TArray<FHoudiniCurvesPart> Parts;
-	for (const HAPI_PartInfo& PartInfo : PartInfos)
-		Parts.Add(FHoudiniCurvesPart(PartInfo));
+			Setter.Owner = Owner;
+			OutSetters.Add(MoveTemp(Setter));
+			OutAttribIndices.Add(AttribIdx);
+		}
+	}
+}
 
-	bool bPartialUpdate = false;
-	
-	for (FHoudiniCurvesPart& Part : Parts)
+bool HoudiniZoneShapeOutputUtils::HapiGetPointPropertySetterData(const int32& NodeId, const int32& PartId, const TArray<std::string>& AttribNames,
+	const TArray<int32>& AttribIndices, TArray<FHoudiniZoneShapePointPropertySetter>& InOutSetters)
+{
+	for (int32 SetterIdx = 0; SetterIdx < InOutSetters.Num(); ++SetterIdx)
 	{
-		const HAPI_PartInfo& PartInfo = Part.Info;
-		const HAPI_PartId& PartId = PartInfo.id;
+		FHoudiniZoneShapePointPropertySetter& Setter = InOutSetters[SetterIdx];
+		const char* AttribName = AttribNames[AttribIndices[SetterIdx]].c_str();
 
+		HAPI_AttributeInfo AttribInfo;
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			AttribName, Setter.Owner, &AttribInfo));
 
-		// -------- Retrieve attrib and group names --------
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetAttributeNames(NodeId, PartId, PartInfo.attributeCounts, Part.AttribNames));
-		const TArray<std::string>& AttribNames = Part.AttribNames;
+		if (!AttribInfo.exists || (AttribInfo.tupleSize != 1))  // Data stays empty, then the attrib will be left to FHoudiniAttribute
+			continue;
 
+		if (IsFloatStorage(AttribInfo.storage))
+		{
+			Setter.Data.SetNumUninitialized(AttribInfo.count);
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				AttribName, &AttribInfo, -1, Setter.Data.GetData(), 0, AttribInfo.count));
+		}
+		else if (IsIntStorage(AttribInfo.storage))
+		{
+			TArray<int32> IntData;
+			IntData.SetNumUninitialized(AttribInfo.count);
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeIntData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				AttribName, &AttribInfo, -1, IntData.GetData(), 0, AttribInfo.count));
 
-		// -------- Retrieve split values and partial output modes if exists --------
-		TArray<int32> SplitKeys;  // Maybe int or HAPI_StringHandle
-		HAPI_AttributeOwner SplitAttribOwner = HAPI_ATTROWNER_PRIM;  // Prefer on prim
-		TMap<HAPI_StringHandle, FString> SplitValueMap;
-		FHoudiniOutputUtils::HapiGetSplitValues(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
-			SplitKeys, SplitValueMap, SplitAttribOwner);
-		const bool bHasSplitValues = !SplitKeys.IsEmpty();
+			Setter.Data.SetNumUninitialized(AttribInfo.count);
+			for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
+				Setter.Data[ElemIdx] = float(IntData[ElemIdx]);
+		}
+	}
 
-		HAPI_AttributeOwner PartialOutputModeOwner = bHasSplitValues ? FHoudiniEngineUtils::QueryAttributeOwner(AttribNames,
-			PartInfo.attributeCounts, HAPI_ATTRIB_PARTIAL_OUTPUT_MODE) : HAPI_ATTROWNER_INVALID;
-		TArray<int8> PartialOutputModes;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
-			HAPI_ATTRIB_PARTIAL_OUTPUT_MODE, PartialOutputModes, PartialOutputModeOwner));
+	return true;
+}
 
+void FHoudiniZoneShapePart::BuildPoints(const int32& CurveIdx, const bool& bIsPolygon,
+	const TArray<FZoneLaneProfile>& LaneProfiles, TArray<FZoneShapePoint>& OutPoints, TArray<int32>& OutPerPointLaneProfileIndices) const
+{
+	const int32 StartVertexIdx = (CurveIdx == 0) ? 0 : VertexIndices[CurveIdx - 1];
+	const int32 NumCurvePoints = VertexIndices[CurveIdx] - StartVertexIdx;
+	OutPoints.SetNum(NumCurvePoints);
+	OutPerPointLaneProfileIndices.Reset();
 
-		// -------- Retrieve vertex list --------
-		TArray<int32> CurveCounts;
-		CurveCounts.SetNumUninitialized(PartInfo.faceCount);
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetCurveCounts(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-			CurveCounts.GetData(), 0, PartInfo.faceCount));
+	for (int32 PointIdx = 0; PointIdx < NumCurvePoints; ++PointIdx)
+	{
+		FZoneShapePoint& Point = OutPoints[PointIdx];
+		Point = FZoneShapePoint();  // Reset
+		const int32 GlobalPointIdx = PointIdx + StartVertexIdx;
+		if (!Rots.IsEmpty())
+			Point.Rotation = Rots[FHoudiniOutputUtils::CurveAttributeEntryIdx(RotOwner, GlobalPointIdx, CurveIdx)];
+
+		Point.LaneProfile = FZoneShapePoint::InheritLaneProfile;
+		if (!PointLaneProfileIndices.IsEmpty() && bIsPolygon)
+		{
+			Point.Type = FZoneShapePointType::LaneProfile;
+			const int32& LaneProfileIdx = PointLaneProfileIndices[GlobalPointIdx];
+			if (LaneProfiles.IsValidIndex(LaneProfileIdx))
+				Point.LaneProfile = uint8(OutPerPointLaneProfileIndices.AddUnique(LaneProfileIdx));
+		}
+	}
 
+	HoudiniMassConversion::PositionsToUnreal(PositionData.GetData() + StartVertexIdx * 3, OutPoints);  // After reset, curve points are contiguous
 
-		// -------- Split curves --------
-		TMap<int32, FHoudiniCurveIndicesHolder>& SplitMap = Part.SplitCurvesMap;
-		FHoudiniCurveIndicesHolder AllCurves(HAPI_PARTIAL_OUTPUT_MODE_REPLACE, FString());
-		int32 VertexIdx = 0;  // The first vertex/point index of this curve, will accumulate each CurveCount
-		for (int32 CurveIdx = 0; CurveIdx < PartInfo.faceCount; ++CurveIdx)
+	for (const FHoudiniZoneShapePointPropertySetter& Setter : PointPropSetters)
+		Setter.Set(OutPoints, StartVertexIdx);
+}
+
+void FHoudiniZoneShapeCapture::Serialize(FArchive& Ar, TArray<FZoneLaneProfile>& InOutLaneProfiles, TArray<FHoudiniZoneShapePart>& InOutParts)
+{
+	auto SerializeOwnerLambda = [&Ar](HAPI_AttributeOwner& Owner)
 		{
-			// Same as HoudiniOutputMesh
-			// Judge PartialOutputMode, if remove && previous NOT set, then we will NOT parse the GroupIdx
-			const int32 SplitKey = bHasSplitValues ?
-				SplitKeys[FHoudiniOutputUtils::CurveAttributeEntryIdx(SplitAttribOwner, VertexIdx, CurveIdx)] : 0;
-			FHoudiniCurveIndicesHolder* FoundHolderPtr = bHasSplitValues ? SplitMap.Find(SplitKey) : nullptr;
+			int32 OwnerValue = int32(Owner);
+			Ar << OwnerValue;
+			Owner = HAPI_AttributeOwner(OwnerValue);
+		};
+
+	// -------- Lane profiles --------
+	int32 NumLaneProfiles = InOutLaneProfiles.Num();
+	Ar << NumLaneProfiles;
+	if (Ar.IsLoading())
+		InOutLaneProfiles.SetNum(NumLaneProfiles);
+	for (FZoneLaneProfile& LaneProfile : InOutLaneProfiles)
+	{
+		Ar << LaneProfile.Name << LaneProfile.ID;
+		int32 NumLanes = LaneProfile.Lanes.Num();
+		Ar << NumLanes;
+		if (Ar.IsLoading())
+			LaneProfile.Lanes.SetNum(NumLanes);
+		for (FZoneLaneDesc& Lane : LaneProfile.Lanes)
+		{
+			uint8 Direction = uint8(Lane.Direction);
+			uint32 Tags = Lane.Tags.GetValue();
+			Ar << Lane.Width << Direction << Tags;
+			Lane.Direction = EZoneLaneDirection(Direction);
+			Lane.Tags = FZoneGraphTagMask(Tags);
+		}
+	}
 
-			const int8 PartialOutputMode = FMath::Clamp(PartialOutputModes.IsEmpty() ? HAPI_PARTIAL_OUTPUT_MODE_REPLACE :
-				PartialOutputModes[FHoudiniOutputUtils::CurveAttributeEntryIdx(PartialOutputModeOwner, VertexIdx, CurveIdx)],
-				HAPI_PARTIAL_OUTPUT_MODE_REPLACE, HAPI_PARTIAL_OUTPUT_MODE_REMOVE);
+	// -------- Parts --------
+	int32 NumParts = InOutParts.Num();
+	Ar << NumParts;
+	if (Ar.IsLoading())
+	{
+		HAPI_PartInfo EmptyPartInfo;
+		FMemory::Memzero(EmptyPartInfo);  // Do NOT use FHoudiniApi::PartInfo_Init, as HAPI may not be loaded when replay
+		InOutParts.Reset(NumParts);
+		for (int32 PartIdx = 0; PartIdx < NumParts; ++PartIdx)
+			InOutParts.Add(FHoudiniZoneShapePart(EmptyPartInfo));
+	}
+	for (FHoudiniZoneShapePart& Part : InOutParts)
+	{
+		int32 PartType = int32(Part.Info.type);
+		Ar << Part.Info.id << PartType << Part.Info.faceCount << Part.Info.pointCount << Part.Info.vertexCount;
+		Part.Info.type = HAPI_PartType(PartType);
 
-			if (PartialOutputMode == HAPI_PARTIAL_OUTPUT_MODE_MODIFY)
-				bPartialUpdate = true;
-			else if (PartialOutputMode == HAPI_PARTIAL_OUTPUT_MODE_REMOVE)  // If has PartialOutputModes, then must also HasSplitValues
+		Ar << Part.VertexIndices;
+
+		int32 NumSplits = Part.SplitCurvesMap.Num();
+		Ar << NumSplits;
+		if (Ar.IsLoading())
+		{
+			Part.SplitCurvesMap.Empty(NumSplits);
+			for (int32 SplitIdx = 0; SplitIdx < NumSplits; ++SplitIdx)
 			{
-				bPartialUpdate = true;
-				if (FoundHolderPtr)  // If previous triangles has identified PartialOutputMode, We should NOT change it
+				int32 SplitKey = 0;
+				int8 PartialOutputMode = 0;
+				FString SplitValue;
+				Ar << SplitKey << PartialOutputMode << SplitValue;
+				Ar << Part.SplitCurvesMap.Add(SplitKey, FHoudiniZoneShapeCurves(PartialOutputMode, SplitValue)).CurveIndices;
+			}
+		}
+		else
+		{
+			for (auto& SplitCurves : Part.SplitCurvesMap)
+				Ar << SplitCurves.Key << SplitCurves.Value.PartialOutputMode << SplitCurves.Value.SplitValue << SplitCurves.Value.CurveIndices;
+		}
+
+		Ar << Part.PositionData;
+
+		SerializeOwnerLambda(Part.RotOwner);
+		Ar << Part.Rots;
+
+		SerializeOwnerLambda(Part.ZoneShapeTypeOwner);
+		Ar << Part.ZoneShapeTypes;
+
+		Ar << Part.PointLaneProfileIndices;
+		SerializeOwnerLambda(Part.LaneProfileOwner);
+		Ar << Part.LaneProfileIndices;
+
+		SerializeOwnerLambda(Part.ZoneGraphTagOwner);
+		int32 NumTags = Part.ZoneGraphTags.Num();
+		Ar << NumTags;
+		if (Ar.IsLoading())
+			Part.ZoneGraphTags.SetNum(NumTags);
+		for (FZoneGraphTagMask& Tags : Part.ZoneGraphTags)
+		{
+			uint32 TagsValue = Tags.GetValue();
+			Ar << TagsValue;
+			Tags = FZoneGraphTagMask(TagsValue);
+		}
+
+		SerializeOwnerLambda(Part.SplitActorsOwner);
+		Ar << Part.bSplitActors;
+
+		SerializeOwnerLambda(Part.ShapeIdOwner);
+		Ar << Part.ShapeIds;
+
+		int32 NumPointPropSetters = Part.PointPropSetters.Num();
+		Ar << NumPointPropSetters;
+		if (Ar.IsLoading())
+			Part.PointPropSetters.SetNum(NumPointPropSetters);
+		for (FHoudiniZoneShapePointPropertySetter& Setter : Part.PointPropSetters)
+		{
+			FName PropertyName = Setter.Property ? Setter.Property->GetFName() : NAME_None;
+			Ar << PropertyName;
+			SerializeOwnerLambda(Setter.Owner);
+			Ar << Setter.Data;
+			if (Ar.IsLoading())
+				Setter.Init(PropertyName);
+		}
+		if (Ar.IsLoading())
+			Part.PointPropSetters.RemoveAll([](const FHoudiniZoneShapePointPropertySetter& Setter) { return !Setter.Property; });
+	}
+}
+
+bool FHoudiniZoneShapeCapture::Save(const FString& FilePath, const TArray<FZoneLaneProfile>& InLaneProfiles, const TArray<FHoudiniZoneShapePart>& InParts)
+{
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!FileWriter)
+		return false;
+
+	FNameAsStringProxyArchive Ar(*FileWriter);
+	uint32 FileMagic = Magic;
+	int32 FileVersion = Version;
+	Ar << FileMagic << FileVersion;
+	Serialize(Ar, const_cast<TArray<FZoneLaneProfile>&>(InLaneProfiles), const_cast<TArray<FHoudiniZoneShapePart>&>(InParts));  // Saving will NOT modify them
+
+	return FileWriter->Close();
+}
+
+bool FHoudiniZoneShapeCapture::Load(const FString& FilePath)
+{
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!FileReader)
+		return false;
+
+	FNameAsStringProxyArchive Ar(*FileReader);
+	uint32 FileMagic = 0;
+	int32 FileVersion = 0;
+	Ar << FileMagic << FileVersion;
+	if ((FileMagic != Magic) || (FileVersion != Version))
+	{
+		UE_LOG(LogHoudiniEngine, Error, TEXT("%s is NOT a zone shape output capture of version %d"), *FilePath, Version);
+		return false;
+	}
+
+	Serialize(Ar, LaneProfiles, Parts);
+
+	return !Ar.IsError();
+}
+
+void HoudiniZoneShapeOutputUtils::CollectComponentProperties(FHoudiniZoneShapePart& Part, const TArray<std::string>& PropAttribNames)
+{
+	static const size_t PrefixLength = strlen(HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY);
+	const int* AttribCounts = Part.Info.attributeCounts;
+	const int32 StartAttribIdx = AttribCounts[HAPI_ATTROWNER_VERTEX] + AttribCounts[HAPI_ATTROWNER_POINT];  // Attribute names are sorted by owner
+	const int32 EndAttribIdx = FMath::Min(StartAttribIdx + AttribCounts[HAPI_ATTROWNER_PRIM] + AttribCounts[HAPI_ATTROWNER_DETAIL], PropAttribNames.Num());
+	for (int32 AttribIdx = StartAttribIdx; AttribIdx < EndAttribIdx; ++AttribIdx)
+	{
+		const std::string& AttribName = PropAttribNames[AttribIdx];
+		if ((AttribName.length() <= PrefixLength) || (strncmp(AttribName.c_str(), HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY, PrefixLength) != 0))
+			continue;
+
+		if (const FProperty* Property = UZoneShapeComponent::StaticClass()->FindPropertyByName(UTF8_TO_TCHAR(AttribName.c_str() + PrefixLength)))
+			Part.ComponentProperties.AddUnique(Property);
+		else
+			Part.bHasUnknownComponentProperties = true;
+	}
+}
+
+void HoudiniZoneShapeOutputUtils::FZoneShapeComponentSnapshot::ResetProperties()
+{
+	for (const TPair<const FProperty*, void*>& PropValue : PropertyValues)
+	{
+		PropValue.Key->DestroyValue(PropValue.Value);
+		FMemory::Free(PropValue.Value);
+	}
+	PropertyValues.Empty();
+}
+
+void HoudiniZoneShapeOutputUtils::FZoneShapeComponentSnapshot::Capture(const UZoneShapeComponent* ZSC, const TArray<const FProperty*>& Properties)
+{
+	Points.Reset();
+	Points.Append(ZSC->GetPoints());
+	ShapeType = ZSC->GetShapeType();
+	Tags = ZSC->GetTags();
+	CommonLaneProfile = ZSC->GetCommonLaneProfile();
+	PerPointLaneProfiles = ZSC->GetPerPointLaneProfiles();
+
+	// Parts usually set the same properties, so only reallocate the values when they differ
+	bool bSameProperties = (PropertyValues.Num() == Properties.Num());
+	for (int32 PropIdx = 0; bSameProperties && (PropIdx < Properties.Num()); ++PropIdx)
+		bSameProperties = (PropertyValues[PropIdx].Key == Properties[PropIdx]);
+
+	if (!bSameProperties)
+	{
+		ResetProperties();
+		for (const FProperty* Prop : Properties)
+		{
+			void* Value = FMemory::Malloc(Prop->GetSize(), Prop->GetMinAlignment());
+			Prop->InitializeValue(Value);
+			PropertyValues.Add(TPair<const FProperty*, void*>(Prop, Value));
+		}
+	}
+
+	for (const TPair<const FProperty*, void*>& PropValue : PropertyValues)
+		PropValue.Key->CopyCompleteValue(PropValue.Value, PropValue.Key->ContainerPtrToValuePtr<void>(ZSC));
+}
+
+bool HoudiniZoneShapeOutputUtils::FZoneShapeComponentSnapshot::Equals(const UZoneShapeComponent* ZSC) const
+{
+	auto IsSameLaneProfileLambda = [](const FZoneLaneProfileRef& A, const FZoneLaneProfileRef& B)
+		{
+			return (A.ID == B.ID) && (A.Name == B.Name);
+		};
+
+	if ((ShapeType != ZSC->GetShapeType()) || !(Tags == ZSC->GetTags()) || !IsSameLaneProfileLambda(CommonLaneProfile, ZSC->GetCommonLaneProfile()))
+		return false;
+
+	const TArray<FZoneLaneProfileRef>& NewPerPointLaneProfiles = ZSC->GetPerPointLaneProfiles();
+	if (PerPointLaneProfiles.Num() != NewPerPointLaneProfiles.Num())
+		return false;
+	for (int32 LaneProfileIdx = 0; LaneProfileIdx < PerPointLaneProfiles.Num(); ++LaneProfileIdx)
+	{
+		if (!IsSameLaneProfileLambda(PerPointLaneProfiles[LaneProfileIdx], NewPerPointLaneProfiles[LaneProfileIdx]))
+			return false;
+	}
+
+	const auto& NewPoints = ZSC->GetPoints();
+	if (Points.Num() != NewPoints.Num())
+		return false;
+	const UScriptStruct* PointStruct = FZoneShapePoint::StaticStruct();
+	for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+	{
+		if (!PointStruct->CompareScriptStruct(&Points[PointIdx], &NewPoints[PointIdx], PPF_None))
+			return false;
+	}
+
+	for (const TPair<const FProperty*, void*>& PropValue : PropertyValues)
+	{
+		if (!PropValue.Key->Identical(PropValue.Value, PropValue.Key->ContainerPtrToValuePtr<void>(ZSC), PPF_None))
+			return false;
+	}
+
+	return true;
+}
+
+void HoudiniZoneShapeOutputUtils::PrepareRetrievePartBuffers(FHoudiniZoneShapePart& Part, FZoneShapePartSettingsData& OutSettingsData)
+{
+	const TArray<std::string>& AttribNames = Part.AttribNames;
+	const int* AttribCounts = Part.Info.attributeCounts;
+
+	Part.RotOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, AttribCounts, HAPI_ATTRIB_ROT);
+	Part.ShapeIdOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, AttribCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_ID);
+	CompilePointPropertySetters(AttribNames, AttribCounts, Part.PointPropSetters, OutSettingsData.PointPropAttribIndices);
+}
+
+bool HoudiniZoneShapeOutputUtils::HapiRetrievePartBuffers(const int32& NodeId, FHoudiniZoneShapePart& Part, const FZoneShapePartSettingsData& SettingsData)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniZoneShapeOutputRetrievePartBuffers);
+
+	const HAPI_PartInfo& PartInfo = Part.Info;
+	const HAPI_PartId& PartId = PartInfo.id;
+
+	HAPI_AttributeInfo AttribInfo;
+
+	// -------- Transforms --------
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputTransforms);
+		TArray<float>& PositionData = Part.PositionData;
+		if (PositionData.Num() != PartInfo.pointCount * 3)  // May have been retrieved for grid cells
+		{
+			PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
+
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+		}
+
+		HAPI_AttributeOwner& RotOwner = Part.RotOwner;
+		TArray<FRotator>& Rots = Part.Rots;
+		if (RotOwner != HAPI_ATTROWNER_INVALID)
+		{
+			HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+				HAPI_ATTRIB_ROT, RotOwner, &AttribInfo));
+
+			if (IsFloatStorage(AttribInfo.storage) && ((AttribInfo.tupleSize == 3) || (AttribInfo.tupleSize == 4)))
+			{
+				TArray<float> RotData;
+				RotData.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
+
+				HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+					HAPI_ATTRIB_ROT, &AttribInfo, -1, RotData.GetData(), 0, AttribInfo.count));
+
+				Rots.SetNumUninitialized(AttribInfo.count);
+				if (AttribInfo.tupleSize == 4)
+					HoudiniMassConversion::QuatsToRotators(RotData.GetData(), AttribInfo.count, Rots.GetData());
+				else
+					HoudiniMassConversion::EulersToRotators(RotData.GetData(), AttribInfo.count, Rots.GetData());
+			}
+			else
+				RotOwner = HAPI_ATTROWNER_INVALID;
+		}
+	}
+
+	if (!HapiGetIntAttributeData(NodeId, PartId, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_ID, Part.ShapeIdOwner, Part.ShapeIds))
+		return false;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputPropAttribs);
+		if (!HapiGetPointPropertySetterData(NodeId, PartId, Part.AttribNames, SettingsData.PointPropAttribIndices, Part.PointPropSetters))
+			return false;
+	}
+
+	return true;
+}
+
+bool HoudiniZoneShapeOutputUtils::HapiRetrievePart(const int32& NodeId, FHoudiniZoneShapePart& Part, FZoneShapePartSettingsData& InOutSettingsData)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniZoneShapeOutputRetrievePart);
+
+	const HAPI_PartInfo& PartInfo = Part.Info;
+	const HAPI_PartId& PartId = PartInfo.id;
+	const TArray<std::string>& AttribNames = Part.AttribNames;
+
+	Part.ZoneShapeTypeOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE);
+	HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE, [](const FUtf8StringView& AttribValue)
+		{
+			if ((UE::String::FindFirst(AttribValue, "polygon", ESearchCase::IgnoreCase) != INDEX_NONE))
+				return 1;
+			return 0;
+		}, Part.ZoneShapeTypes, Part.ZoneShapeTypeOwner));
+
+	// Lane Profile
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputLaneProfiles);
+
+		// We should check whether vertex or point has lane profile attrib
+		HAPI_AttributeOwner PointLaneProfileOwner;
+		HOUDINI_FAIL_RETURN(HapiGetLaneProfiles(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
+			true, PointLaneProfileOwner, InOutSettingsData.PointLaneProfiles));
+
+		// We should also check whether prim or detail has lane profile attrib
+		HOUDINI_FAIL_RETURN(HapiGetLaneProfiles(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
+			false, Part.LaneProfileOwner, InOutSettingsData.LaneProfiles));
+	}
+
+	// Zone Shape Tags
+	Part.ZoneGraphTagOwner = FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, HAPI_ATTROWNER_PRIM) ?
+		HAPI_ATTROWNER_PRIM : FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS);
+	HOUDINI_FAIL_RETURN(HapiGetTags(NodeId, PartId, Part.ZoneGraphTagOwner, InOutSettingsData.Tags));
+
+	// Common
+	Part.SplitActorsOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_SPLIT_ACTORS);
+	HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
+		HAPI_ATTRIB_UNREAL_SPLIT_ACTORS, Part.bSplitActors, Part.SplitActorsOwner));
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputPropAttribs);
+
+		// Setters that have retrieved their data will NOT be retrieved again by FHoudiniAttribute, the others are left to it
+		TArray<std::string> PropAttribNames = AttribNames;
+		TArray<int32>& PointPropAttribIndices = InOutSettingsData.PointPropAttribIndices;
+		for (int32 SetterIdx = Part.PointPropSetters.Num() - 1; SetterIdx >= 0; --SetterIdx)
+		{
+			if (Part.PointPropSetters[SetterIdx].Data.IsEmpty())
+			{
+				Part.PointPropSetters.RemoveAt(SetterIdx);
+				PointPropAttribIndices.RemoveAt(SetterIdx);
+			}
+			else
+				PropAttribNames[PointPropAttribIndices[SetterIdx]].clear();
+		}
+
+		HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniAttribute::HapiRetrieveAttributes(NodeId, PartId, PropAttribNames, PartInfo.attributeCounts,
+			HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY, Part.PropAttribs));
+		if (!Part.PropAttribs.IsEmpty())
+			CollectComponentProperties(Part, PropAttribNames);
+	}
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_OutputPoints, PartInfo.pointCount);
+
+	return true;
+}
+
+using namespace HoudiniZoneShapeOutputUtils;
+
+
+bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniOutputZoneShape);
+
+	FlushPendingTask();  // Holders must be settled before we reuse them
+
+	const AHoudiniNode* Node = GetNode();
+
+	const int32& NodeId = GeoInfo.nodeId;
+
+	TSharedPtr<FHoudiniZoneShapeOutputTask> Task = MakeShared<FHoudiniZoneShapeOutputTask>();
+	Task->Output = this;
+
+	// -------- Retrieve all part data --------
+	TArray<FHoudiniZoneShapePart>& Parts = Task->Parts;
+	for (const HAPI_PartInfo& PartInfo : PartInfos)
+		Parts.Add(FHoudiniZoneShapePart(PartInfo));
+
+	bool bPartialUpdate = false;
+	
+	for (FHoudiniZoneShapePart& Part : Parts)
+	{
+		const HAPI_PartInfo& PartInfo = Part.Info;
+		const HAPI_PartId& PartId = PartInfo.id;
+
+
+		// -------- Retrieve attrib and group names --------
+		{
+			SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputAttribNames);
+			HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiGetAttributeNames(NodeId, PartId, PartInfo.attributeCounts, Part.AttribNames));
+		}
+		const TArray<std::string>& AttribNames = Part.AttribNames;
+
+
+		// -------- Retrieve split values and partial output modes if exists --------
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputSplit);
+		TArray<int32> SplitKeys;  // Maybe int or HAPI_StringHandle
+		HAPI_AttributeOwner SplitAttribOwner = HAPI_ATTROWNER_PRIM;  // Prefer on prim
+		TMap<HAPI_StringHandle, FString> SplitValueMap;
+		INC_DWORD_STAT(STAT_HoudiniMass_HapiHelperCalls);
+		FHoudiniOutputUtils::HapiGetSplitValues(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
+			SplitKeys, SplitValueMap, SplitAttribOwner);
+		bool bHasSplitValues = !SplitKeys.IsEmpty();
+
+		HAPI_AttributeOwner PartialOutputModeOwner = bHasSplitValues ? FHoudiniEngineUtils::QueryAttributeOwner(AttribNames,
+			PartInfo.attributeCounts, HAPI_ATTRIB_PARTIAL_OUTPUT_MODE) : HAPI_ATTROWNER_INVALID;
+		TArray<int8> PartialOutputModes;
+		HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
+			HAPI_ATTRIB_PARTIAL_OUTPUT_MODE, PartialOutputModes, PartialOutputModeOwner));
+
+
+		// -------- Retrieve vertex list --------
+		TArray<int32> CurveCounts;
+		CurveCounts.SetNumUninitialized(PartInfo.faceCount);
+		HOUDINI_MASS_HAPI_FAIL_RETURN(FHoudiniApi::GetCurveCounts(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
+			CurveCounts.GetData(), 0, PartInfo.faceCount));
+
+
+		// -------- Split curves into grid cells by their bounds, if no split values --------
+		TArray<FString> CellSplitValues;  // SplitKey -> Cell split value
+		if (!bHasSplitValues)
+		{
+			HOUDINI_FAIL_RETURN(HapiGetGridCells(NodeId, PartId, AttribNames, PartInfo, CurveCounts, Part.PositionData, SplitKeys, CellSplitValues));
+			if (!SplitKeys.IsEmpty())
+			{
+				bHasSplitValues = true;
+				SplitAttribOwner = HAPI_ATTROWNER_PRIM;
+				Part.bGridCells = true;
+			}
+		}
+
+
+		// -------- Split curves --------
+		TMap<int32, FHoudiniZoneShapeCurves>& SplitMap = Part.SplitCurvesMap;
+		FHoudiniZoneShapeCurves AllCurves(HAPI_PARTIAL_OUTPUT_MODE_REPLACE, FString());
+		int32 VertexIdx = 0;  // The first vertex/point index of this curve, will accumulate each CurveCount
+		for (int32 CurveIdx = 0; CurveIdx < PartInfo.faceCount; ++CurveIdx)
+		{
+			// Same as HoudiniOutputMesh
+			// Judge PartialOutputMode, if remove && previous NOT set, then we will NOT parse the GroupIdx
+			const int32 SplitKey = bHasSplitValues ?
+				SplitKeys[FHoudiniOutputUtils::CurveAttributeEntryIdx(SplitAttribOwner, VertexIdx, CurveIdx)] : 0;
+			FHoudiniZoneShapeCurves* FoundHolderPtr = bHasSplitValues ? SplitMap.Find(SplitKey) : nullptr;
+
+			const int8 PartialOutputMode = FMath::Clamp(PartialOutputModes.IsEmpty() ? HAPI_PARTIAL_OUTPUT_MODE_REPLACE :
+				PartialOutputModes[FHoudiniOutputUtils::CurveAttributeEntryIdx(PartialOutputModeOwner, VertexIdx, CurveIdx)],
+				HAPI_PARTIAL_OUTPUT_MODE_REPLACE, HAPI_PARTIAL_OUTPUT_MODE_REMOVE);
+
+			if (PartialOutputMode == HAPI_PARTIAL_OUTPUT_MODE_MODIFY)
+				bPartialUpdate = true;
+			else if (PartialOutputMode == HAPI_PARTIAL_OUTPUT_MODE_REMOVE)  // If has PartialOutputModes, then must also HasSplitValues
+			{
+				bPartialUpdate = true;
+				if (FoundHolderPtr)  // If previous triangles has identified PartialOutputMode, We should NOT change it
 				{
 					if (FoundHolderPtr->PartialOutputMode == HAPI_PARTIAL_OUTPUT_MODE_REMOVE)
 						continue;
 				}
 				else
 				{
-					SplitMap.Add(SplitKey, FHoudiniCurveIndicesHolder(HAPI_PARTIAL_OUTPUT_MODE_REMOVE, GET_SPLIT_VALUE_STR));
+					SplitMap.Add(SplitKey, FHoudiniZoneShapeCurves(HAPI_PARTIAL_OUTPUT_MODE_REMOVE, GET_SPLIT_VALUE_STR));
 					continue;
 				}
 			}
@@ -559,7 +1454,7 @@ bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArr
 			if (bHasSplitValues)
 			{
 				if (!FoundHolderPtr)
-					FoundHolderPtr = &SplitMap.Add(SplitKey, FHoudiniCurveIndicesHolder(PartialOutputMode, GET_SPLIT_VALUE_STR));
+					FoundHolderPtr = &SplitMap.Add(SplitKey, FHoudiniZoneShapeCurves(PartialOutputMode, (CellSplitValues.IsEmpty() ? FString(GET_SPLIT_VALUE_STR) : CellSplitValues[SplitKey])));
 				FoundHolderPtr->CurveIndices.Add(CurveIdx);
 			}
 			else
@@ -576,13 +1471,13 @@ bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArr
 	TDoubleLinkedList<FHoudiniZoneShapeOutput*> OldZoneShapeOutputs;
 	TArray<FHoudiniZoneShapeOutput> NewZoneShapeOutputs;
 
+	TSet<FString> RemoveSplitValues;  // Also used to release lane profile references
 	if (bPartialUpdate)
 	{
 		TSet<FString> ModifySplitValues;
-		TSet<FString> RemoveSplitValues;
-		for (FHoudiniCurvesPart& Part : Parts)
+		for (FHoudiniZoneShapePart& Part : Parts)
 		{
-			for (TMap<int32, FHoudiniCurveIndicesHolder>::TIterator SplitIter(Part.SplitCurvesMap); SplitIter; ++SplitIter)
+			for (TMap<int32, FHoudiniZoneShapeCurves>::TIterator SplitIter(Part.SplitCurvesMap); SplitIter; ++SplitIter)
 			{
 				if (SplitIter->Value.PartialOutputMode >= HAPI_PARTIAL_OUTPUT_MODE_REMOVE)
 				{
@@ -601,191 +1496,496 @@ bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArr
 		FHoudiniOutputUtils::UpdateOutputHolders(ZoneShapeOutputs,
 			[Node](const FHoudiniZoneShapeOutput& OldZSOutput) { return IsValid(OldZSOutput.Find(Node)); }, OldZoneShapeOutputs);
 
+	// Index the old output holders by split value, and by stable shape id, so that each curve finds its holder in O(1)
+	struct FHoudiniZoneShapeOutputBucket
+	{
+		TMap<int32, FHoudiniZoneShapeOutput*> IdOutputMap;
+		TArray<FHoudiniZoneShapeOutput*> Outputs;  // Holders without shape id
+
+		FHoudiniZoneShapeOutput* PopById(const int32& ShapeId)
+		{
+			FHoudiniZoneShapeOutput* FoundOutput = nullptr;
+			if (ShapeId >= 0)
+				IdOutputMap.RemoveAndCopyValue(ShapeId, FoundOutput);
+			return FoundOutput;
+		}
+
+		FHoudiniZoneShapeOutput* Pop()  // Should only be called after all curves have popped by their ids
+		{
+			if (!Outputs.IsEmpty())
+				return Outputs.Pop();
+
+			FHoudiniZoneShapeOutput* FoundOutput = nullptr;
+			if (!IdOutputMap.IsEmpty())  // Fallback to reuse a holder that has another id
+			{
+				TMap<int32, FHoudiniZoneShapeOutput*>::TIterator IdIter(IdOutputMap);
+				FoundOutput = IdIter->Value;
+				IdIter.RemoveCurrent();
+			}
+
+			return FoundOutput;
+		}
+	};
+
+	struct FHoudiniZoneShapeSplitOutputs
+	{
+		FHoudiniZoneShapeOutputBucket Buckets[2];  // Index is bSplitActor
+	};
+
+	TMap<FString, FHoudiniZoneShapeSplitOutputs> OldZSOutputMap;
+	for (FHoudiniZoneShapeOutput* OldZSOutput : OldZoneShapeOutputs)
+	{
+		FHoudiniZoneShapeOutputBucket& Bucket = OldZSOutputMap.FindOrAdd(OldZSOutput->GetSplitValue()).Buckets[OldZSOutput->IsSplitActor() ? 1 : 0];
+		if ((OldZSOutput->GetShapeId() < 0) || Bucket.IdOutputMap.Contains(OldZSOutput->GetShapeId()))
+			Bucket.Outputs.Add(OldZSOutput);
+		else
+			Bucket.IdOutputMap.Add(OldZSOutput->GetShapeId(), OldZSOutput);
+	}
+
 	FHoudiniEngine::Get().FinishHoudiniMainTaskMessage();  // Avoid RHI crash
 
 	UZoneGraphSettings* ZoneGraphSettings = GetMutableDefault<UZoneGraphSettings>();
 	
-	TMap<uint32, int32> HashProfileIdxMap;  // Find all unique lane profiles
-	for (int32 ProfileIdx = 0; ProfileIdx < ZoneGraphSettings->GetLaneProfiles().Num(); ++ProfileIdx)
-		HashProfileIdxMap.FindOrAdd(GetLaneProfileHash(ZoneGraphSettings->GetLaneProfiles()[ProfileIdx].Lanes), ProfileIdx);
-
-	FArrayProperty* ShapeConnectorsProp = CastField<FArrayProperty>(UZoneShapeComponent::StaticClass()->FindPropertyByName("ShapeConnectors"));
-	FArrayProperty* ConnectedShapesProp = CastField<FArrayProperty>(UZoneShapeComponent::StaticClass()->FindPropertyByName("ConnectedShapes"));
+	FHoudiniZoneGraphSettingsCache& SettingsCache = FHoudiniMassTranslator::Get().GetZoneGraphSettingsCache();  // Lane profiles are indexed across cooks
 
 	bool bZoneGraphSettingsModified = false;
-	TMap<AActor*, TArray<FString>> ActorPropertyNamesMap;  // Use to avoid Set the same property in same SplitActor twice
-	HAPI_AttributeInfo AttribInfo;
-	TArray<UZoneShapeComponent*> ChangedZSCs;
-	for (const FHoudiniCurvesPart& Part : Parts)
+	TArray<int32> UnboundCurveIndices;  // Curves that found no holder of their id, will take the rest holders of their split value after all ids bound
+	for (int32 PartIdx = 0; PartIdx < Parts.Num(); ++PartIdx)
 	{
+		FHoudiniZoneShapePart& Part = Parts[PartIdx];
 		if (Part.SplitCurvesMap.IsEmpty())
 			continue;
 
-		const HAPI_PartInfo& PartInfo = Part.Info;
-		const HAPI_PartId& PartId = PartInfo.id;
-		const TArray<std::string>& AttribNames = Part.AttribNames;
-
-		// -------- Transforms --------
-		TArray<float> PositionData;
-		PositionData.SetNumUninitialized(PartInfo.pointCount * 3);
-
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-			HAPI_ATTRIB_POSITION, HAPI_ATTROWNER_POINT, &AttribInfo));
+		FZoneShapePartSettingsData PartSettingsData;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputRetrievePart);
+			PrepareRetrievePartBuffers(Part, PartSettingsData);
+			if (!HapiRetrievePartBuffers(NodeId, Part, PartSettingsData) || !HapiRetrievePart(NodeId, Part, PartSettingsData))
+				return false;
+		}
 
-		HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-			HAPI_ATTRIB_POSITION, &AttribInfo, -1, PositionData.GetData(), 0, PartInfo.pointCount));
+		// -------- Resolve lane profiles and tags, as UZoneGraphSettings could only be modified on game thread --------
+		{
+			SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputLaneProfiles);
+			PartSettingsData.PointLaneProfiles.Resolve(ZoneGraphSettings, SettingsCache, Part.PointLaneProfileIndices, bZoneGraphSettingsModified);
+			PartSettingsData.LaneProfiles.Resolve(ZoneGraphSettings, SettingsCache, Part.LaneProfileIndices, bZoneGraphSettingsModified);
+		}
+		PartSettingsData.Tags.Resolve(ZoneGraphSettings, SettingsCache, Part.ZoneGraphTags, bZoneGraphSettingsModified);
 
-		HAPI_AttributeOwner RotOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_ROT);
-		TArray<FRotator> Rots;
-		if (RotOwner != HAPI_ATTROWNER_INVALID)
+		// -------- Bind output holders by shape ids, components will be created or updated by the task --------
+		const TArray<int32>& VertexIndices = Part.VertexIndices;
+		for (const auto& SplitCurves : Part.SplitCurvesMap)
 		{
-			HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeInfo(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-				HAPI_ATTRIB_ROT, RotOwner, &AttribInfo));
+			const FString& SplitValue = SplitCurves.Value.SplitValue;
+			FHoudiniZoneShapeSplitOutputs* OldSplitZSOutputs = OldZSOutputMap.Find(SplitValue);
 
-			if (((AttribInfo.storage == HAPI_STORAGETYPE_FLOAT) || (AttribInfo.storage == HAPI_STORAGETYPE_FLOAT64)) &&
-				((AttribInfo.tupleSize == 3) || (AttribInfo.tupleSize == 4)))
+			for (const int32& CurveIdx : SplitCurves.Value.CurveIndices)
 			{
-				TArray<float> RotData;
-				RotData.SetNumUninitialized(AttribInfo.count * AttribInfo.tupleSize);
+				const int32 MainVertexIdx = (CurveIdx == 0) ? 0 : VertexIndices[CurveIdx - 1];
 
-				HAPI_SESSION_FAIL_RETURN(FHoudiniApi::GetAttributeFloatData(FHoudiniEngine::Get().GetSession(), NodeId, PartId,
-					HAPI_ATTRIB_ROT, &AttribInfo, -1, RotData.GetData(), 0, AttribInfo.count));
+				bool bSplitActor = Part.bGridCells;  // Each cell should be an actor by default
+				if (!Part.bSplitActors.IsEmpty())
+					bSplitActor = Part.bSplitActors[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.SplitActorsOwner, MainVertexIdx, CurveIdx)] >= 1;
 
-				Rots.SetNumUninitialized(AttribInfo.count);
-				if (AttribInfo.tupleSize == 4)
-				{
-					for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-						Rots[ElemIdx] = FQuat(RotData[ElemIdx * 4], RotData[ElemIdx * 4 + 2], RotData[ElemIdx * 4 + 1], -RotData[ElemIdx * 4 + 3]).Rotator();
-				}
-				else
-				{
-					for (int32 ElemIdx = 0; ElemIdx < AttribInfo.count; ++ElemIdx)
-						Rots[ElemIdx] = FRotator(FMath::RadiansToDegrees(RotData[ElemIdx * 3]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 2]), FMath::RadiansToDegrees(RotData[ElemIdx * 3 + 1]));
-				}
+				const int32 ShapeId = Part.ShapeIds.IsEmpty() ? -1 : Part.ShapeIds[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.ShapeIdOwner, MainVertexIdx, CurveIdx)];
+
+				FHoudiniZoneShapeOutput NewZSOutput;
+				FHoudiniZoneShapeOutput* FoundZSOutput = OldSplitZSOutputs ? OldSplitZSOutputs->Buckets[bSplitActor ? 1 : 0].PopById(ShapeId) : nullptr;
+				if (FoundZSOutput)
+					NewZSOutput = *FoundZSOutput;
+				NewZSOutput.SetShapeId(ShapeId);
+
+				if (!FoundZSOutput)
+					UnboundCurveIndices.Add(Task->Curves.Num());
+				Task->Curves.Add(FHoudiniZoneShapeOutputTask::FCurve{ NewZoneShapeOutputs.Add(NewZSOutput), PartIdx, CurveIdx, bSplitActor, &SplitValue });
 			}
-			else
-				RotOwner = HAPI_ATTROWNER_INVALID;
+		}
+	}
+
+	// -------- Assign the rest old holders of the same split value to the unbound curves, holders without id first --------
+	// Only after all curves have bound by their ids, otherwise a new curve may take the holder of an id that appears in later curves
+	for (const int32& UnboundCurveIdx : UnboundCurveIndices)
+	{
+		const FHoudiniZoneShapeOutputTask::FCurve& Curve = Task->Curves[UnboundCurveIdx];
+		FHoudiniZoneShapeSplitOutputs* OldSplitZSOutputs = OldZSOutputMap.Find(*Curve.SplitValue);
+		FHoudiniZoneShapeOutput* FoundZSOutput = OldSplitZSOutputs ? OldSplitZSOutputs->Buckets[Curve.bSplitActor ? 1 : 0].Pop() : nullptr;
+		if (FoundZSOutput)
+		{
+			FHoudiniZoneShapeOutput& NewZSOutput = NewZoneShapeOutputs[Curve.OutputIdx];
+			const int32 ShapeId = NewZSOutput.GetShapeId();
+			NewZSOutput = *FoundZSOutput;
+			NewZSOutput.SetShapeId(ShapeId);
+		}
+	}
+
+	// -------- Record lane profile references of each split value, for cleanup --------
+	{
+		const TArray<FZoneLaneProfile>& LaneProfiles = ZoneGraphSettings->GetLaneProfiles();
+		TMap<FString, TSet<int32>> SplitLaneProfileIndicesMap;
+		for (const FHoudiniZoneShapePart& Part : Parts)
+		{
+			for (const auto& SplitCurves : Part.SplitCurvesMap)
+				CollectLaneProfileIndices(Part, SplitCurves.Value, SplitLaneProfileIndicesMap.FindOrAdd(SplitCurves.Value.SplitValue));
+		}
+
+		TArray<FHoudiniLaneProfileReferences> NewLaneProfileReferences;
+		if (bPartialUpdate)  // Keep the references of split values that are NOT output this time
+		{
+			NewLaneProfileReferences = LaneProfileReferences;
+			NewLaneProfileReferences.RemoveAll([&](const FHoudiniLaneProfileReferences& Refs)
+				{
+					return RemoveSplitValues.Contains(Refs.SplitValue) || SplitLaneProfileIndicesMap.Contains(Refs.SplitValue);
+				});
 		}
 
-		HAPI_AttributeOwner ZoneShapeTypeOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE);
-		TArray<int8> ZoneShapeTypes;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
-			HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE, [](const FUtf8StringView& AttribValue)
+		for (const auto& SplitLaneProfileIndices : SplitLaneProfileIndicesMap)
+		{
+			TArray<FGuid> LaneProfileIDs;
+			for (const int32& LaneProfileIdx : SplitLaneProfileIndices.Value)
+			{
+				if (LaneProfiles.IsValidIndex(LaneProfileIdx) && LaneProfiles[LaneProfileIdx].Name.ToString().StartsWith(HOUDINI_LANE_PROFILE_PREFIX))  // Only houdini lane profiles will be cleaned up
+					LaneProfileIDs.Add(LaneProfiles[LaneProfileIdx].ID);
+			}
+			if (!LaneProfileIDs.IsEmpty())
 			{
-				if ((UE::String::FindFirst(AttribValue, "polygon", ESearchCase::IgnoreCase) != INDEX_NONE))
-					return 1;
-				return 0;
-			}, ZoneShapeTypes, ZoneShapeTypeOwner));
-
-		// Lane Profile
-		TArray<int32> PointLaneProfileIndices;
-		HAPI_AttributeOwner LaneProfileOwner = HAPI_ATTROWNER_INVALID;  // For Curve, maybe on prim or detail
-		TArray<int32> LaneProfileIndices;  // For Curve, maybe on prim or detail
-		{
-			// We should check whether vertex or point has lane profile attrib
-			HAPI_AttributeOwner PointLaneProfileOwner;
-			HOUDINI_FAIL_RETURN(HapiGetOrCreateLaneProfiles(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
-				ZoneGraphSettings, true, PointLaneProfileOwner, HashProfileIdxMap, PointLaneProfileIndices, bZoneGraphSettingsModified));
-
-			// We should also check whether prim or detail has lane profile attrib
-			HOUDINI_FAIL_RETURN(HapiGetOrCreateLaneProfiles(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
-				ZoneGraphSettings, false, LaneProfileOwner, HashProfileIdxMap, LaneProfileIndices, bZoneGraphSettingsModified));
-		}
-
-		// Zone Shape Tags
-		HAPI_AttributeOwner ZoneGraphTagOwner = FHoudiniEngineUtils::IsAttributeExists(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS, HAPI_ATTROWNER_PRIM) ?
-			HAPI_ATTROWNER_PRIM : FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS);
-		TArray<FZoneGraphTagMask> ZoneGraphTags;
-		HOUDINI_FAIL_RETURN(HapiGetOrCreateTags(NodeId, PartId, ZoneGraphSettings, ZoneGraphTagOwner, ZoneGraphTags, bZoneGraphSettingsModified));
-
-		// Common
-		HAPI_AttributeOwner SplitActorsOwner = FHoudiniEngineUtils::QueryAttributeOwner(AttribNames, PartInfo.attributeCounts, HAPI_ATTRIB_UNREAL_SPLIT_ACTORS);
-		TArray<int8> bSplitActors;
-		HOUDINI_FAIL_RETURN(FHoudiniEngineUtils::HapiGetEnumAttributeData(NodeId, PartId,
-			HAPI_ATTRIB_UNREAL_SPLIT_ACTORS, bSplitActors, SplitActorsOwner));
-
-		TArray<TSharedPtr<FHoudiniAttribute>> PropAttribs;
-		HOUDINI_FAIL_RETURN(FHoudiniAttribute::HapiRetrieveAttributes(NodeId, PartId, AttribNames, PartInfo.attributeCounts,
-			HAPI_ATTRIB_PREFIX_UNREAL_UPROPERTY, PropAttribs));
+				LaneProfileIDs.Sort([](const FGuid& A, const FGuid& B) { return A < B; });
+				NewLaneProfileReferences.Add(FHoudiniLaneProfileReferences{ SplitLaneProfileIndices.Key, LaneProfileIDs });
+			}
+		}
+		NewLaneProfileReferences.Sort([](const FHoudiniLaneProfileReferences& A, const FHoudiniLaneProfileReferences& B) { return A.SplitValue < B.SplitValue; });  // Stable order, so that unchanged references will NOT dirty the registry
 
-		const TArray<int32>& VertexIndices = Part.VertexIndices;
-		for (const auto& SplitCurves : Part.SplitCurvesMap)
+		if (NewLaneProfileReferences != LaneProfileReferences)
 		{
-			const FString& SplitValue = SplitCurves.Value.SplitValue;
+			Modify();  // So that undo/redo restores the references, then re-registers them in PostEditUndo
+			LaneProfileReferences = NewLaneProfileReferences;
+		}
+		RegisterLaneProfileReferences();
+	}
+
+	// -------- Post-processing --------
+	if (bZoneGraphSettingsModified)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputConfigWrite);
+		ZoneGraphSettings->TryUpdateDefaultConfigFile();
+	}
+
+	INC_DWORD_STAT_BY(STAT_HoudiniMass_OutputCurves, Task->Curves.Num());
+
+	if (CVarCaptureZoneShapeOutput.GetValueOnGameThread())
+	{
+		const FString CaptureFilePath = FPaths::ProjectSavedDir() / TEXT("HoudiniMass") /
+			FString::Printf(TEXT("%s_%s_%s.zscapture"), IsValid(Node) ? *Node->GetActorNameOrLabel() : TEXT("None"), *GetName(), *FDateTime::Now().ToString());
+		if (FHoudiniZoneShapeCapture::Save(CaptureFilePath, ZoneGraphSettings->GetLaneProfiles(), Parts))
+			UE_LOG(LogHoudiniEngine, Display, TEXT("Zone shape output captured: %s"), *CaptureFilePath);
+	}
+
+	// Old outputs that have not been reused, should be destroyed after the new components created, like this->Destroy()
+	for (const auto& OldSplitZSOutputs : OldZSOutputMap)
+	{
+		for (const FHoudiniZoneShapeOutputBucket& Bucket : OldSplitZSOutputs.Value.Buckets)
+		{
+			for (const auto& IdOldZSOutput : Bucket.IdOutputMap)
+				Task->OldOutputs.Add(*IdOldZSOutput.Value);
+			for (const FHoudiniZoneShapeOutput* OldZSOutput : Bucket.Outputs)
+				Task->OldOutputs.Add(*OldZSOutput);
+		}
+	}
+	OldZSOutputMap.Empty();
+	OldZoneShapeOutputs.Empty();
+
+	// Update output holders
+	ZoneShapeOutputs = NewZoneShapeOutputs;
+
+	const UHoudiniMassSettings* Settings = GetDefault<UHoudiniMassSettings>();
+	if (Settings->bTimeSliceZoneShapeOutput && !Task->Curves.IsEmpty())
+	{
+		PendingTask = Task;
+		FHoudiniMassTranslator::Get().AddZoneShapeOutputTask(Task);
+		return true;
+	}
+
+	Task->Process(DBL_MAX);
+
+	if (Task->HasChangedShapes())
+		AsyncTask(ENamedThreads::GameThread, [] { FHoudiniMassTranslator::Get().OnZoneShapeOutputFinish(); });  // After all outputs finished
+
+	return true;
+}
+
+void UHoudiniOutputZoneShape::FlushPendingTask()
+{
+	if (PendingTask.IsValid())
+	{
+		PendingTask->Process(DBL_MAX);  // Module will notify when it removes the finished task
+		PendingTask.Reset();
+	}
+}
+
+void UHoudiniOutputZoneShape::Destroy() const
+{
+	if (PendingTask.IsValid())
+		PendingTask->Cancel(GetNode());
+
+	for (const FHoudiniZoneShapeOutput& OldZoneShapeOutput : ZoneShapeOutputs)
+		OldZoneShapeOutput.Destroy(GetNode());
+
+	UHoudiniLaneProfileRegistry::Get()->RemoveReferences(GetNode(), this);
+}
+
+void UHoudiniOutputZoneShape::RegisterLaneProfileReferences() const
+{
+	if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) || GetPackage()->HasAnyPackageFlags(PKG_PlayInEditor))
+		return;
+
+	const AHoudiniNode* Node = GetNode();
+	if (IsValid(this) && IsValid(Node))
+		UHoudiniLaneProfileRegistry::Get()->SetReferences(Node, this, LaneProfileReferences);
+	else
+		UHoudiniLaneProfileRegistry::Get()->RemoveReferences(Node, this);
+}
+
+void UHoudiniOutputZoneShape::RecoverLaneProfileReferences()
+{
+	if (!LaneProfileReferences.IsEmpty() || ZoneShapeOutputs.IsEmpty())
+		return;
+
+	const AHoudiniNode* Node = GetNode();
+	TMap<FString, TSet<FGuid>> SplitLaneProfileIDsMap;
+	for (const FHoudiniZoneShapeOutput& ZSOutput : ZoneShapeOutputs)
+	{
+		const UZoneShapeComponent* ZSC = ZSOutput.Find(Node);
+		if (!ZSC)
+			continue;
+
+		TSet<FGuid>& LaneProfileIDs = SplitLaneProfileIDsMap.FindOrAdd(ZSOutput.GetSplitValue());
+		if (ZSC->GetCommonLaneProfile().Name.ToString().StartsWith(HOUDINI_LANE_PROFILE_PREFIX))
+			LaneProfileIDs.Add(ZSC->GetCommonLaneProfile().ID);
+		for (const FZoneLaneProfileRef& LaneProfileRef : ZSC->GetPerPointLaneProfiles())
+		{
+			if (LaneProfileRef.Name.ToString().StartsWith(HOUDINI_LANE_PROFILE_PREFIX))
+				LaneProfileIDs.Add(LaneProfileRef.ID);
+		}
+	}
+
+	for (const auto& SplitLaneProfileIDs : SplitLaneProfileIDsMap)
+	{
+		if (SplitLaneProfileIDs.Value.IsEmpty())
+			continue;
+
+		TArray<FGuid> LaneProfileIDs = SplitLaneProfileIDs.Value.Array();
+		LaneProfileIDs.Sort([](const FGuid& A, const FGuid& B) { return A < B; });
+		LaneProfileReferences.Add(FHoudiniLaneProfileReferences{ SplitLaneProfileIDs.Key, LaneProfileIDs });
+	}
+	LaneProfileReferences.Sort([](const FHoudiniLaneProfileReferences& A, const FHoudiniLaneProfileReferences& B) { return A.SplitValue < B.SplitValue; });
+}
+
+void UHoudiniOutputZoneShape::PostLoad()
+{
+	Super::PostLoad();
+
+	RecoverLaneProfileReferences();
+	if (!LaneProfileReferences.IsEmpty())
+		RegisterLaneProfileReferences();
+}
+
+#if WITH_EDITOR
+void UHoudiniOutputZoneShape::PreEditUndo()
+{
+	FlushPendingTask();  // Task indexes ZoneShapeOutputs, which will be restored by undo/redo
+
+	Super::PreEditUndo();
+}
+
+void UHoudiniOutputZoneShape::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	if (PendingTask.IsValid())  // Should NOT happen, but never apply on the restored holders
+	{
+		PendingTask->Cancel(GetNode());
+		PendingTask.Reset();
+	}
+
+	RegisterLaneProfileReferences();
+}
+#endif
+
+TSharedPtr<FHoudiniZoneShapeOutputTask> FHoudiniZoneShapeOutputTask::Create(UHoudiniOutputZoneShape* InOutput, TArray<FHoudiniZoneShapePart>&& InParts,
+	const TArray<FZoneLaneProfile>* InTransientLaneProfiles)
+{
+	InOutput->FlushPendingTask();
 
+	TSharedPtr<FHoudiniZoneShapeOutputTask> Task = MakeShared<FHoudiniZoneShapeOutputTask>();
+	Task->Output = InOutput;
+	Task->Parts = MoveTemp(InParts);
+	Task->TransientLaneProfiles = InTransientLaneProfiles;
+	Task->OldOutputs = MoveTemp(InOutput->ZoneShapeOutputs);
+	InOutput->ZoneShapeOutputs.Empty();
+
+	// The same as binding in HapiUpdate, but without reusing old holders
+	for (int32 PartIdx = 0; PartIdx < Task->Parts.Num(); ++PartIdx)
+	{
+		const FHoudiniZoneShapePart& Part = Task->Parts[PartIdx];
+		for (const auto& SplitCurves : Part.SplitCurvesMap)
+		{
 			for (const int32& CurveIdx : SplitCurves.Value.CurveIndices)
 			{
-				const int32 MainVertexIdx = (CurveIdx == 0) ? 0 : VertexIndices[CurveIdx - 1];
+				const int32 MainVertexIdx = (CurveIdx == 0) ? 0 : Part.VertexIndices[CurveIdx - 1];
 
-				bool bSplitActor = false;
-				if (!bSplitActors.IsEmpty())
-					bSplitActor = bSplitActors[FHoudiniOutputUtils::CurveAttributeEntryIdx(SplitActorsOwner, MainVertexIdx, CurveIdx)] >= 1;
+				bool bSplitActor = Part.bGridCells;
+				if (!Part.bSplitActors.IsEmpty())
+					bSplitActor = Part.bSplitActors[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.SplitActorsOwner, MainVertexIdx, CurveIdx)] >= 1;
 
 				FHoudiniZoneShapeOutput NewZSOutput;
-				if (FHoudiniZoneShapeOutput* FoundZSOutput = FHoudiniOutputUtils::FindOutputHolder(OldZoneShapeOutputs,
-					[&](FHoudiniZoneShapeOutput* OldZSOutput) { return OldZSOutput->CanReuse(SplitValue, bSplitActor); }))
-					NewZSOutput = *FoundZSOutput;
+				NewZSOutput.SetShapeId(Part.ShapeIds.IsEmpty() ? -1 : Part.ShapeIds[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.ShapeIdOwner, MainVertexIdx, CurveIdx)]);
+				Task->Curves.Add(FCurve{ InOutput->ZoneShapeOutputs.Add(NewZSOutput), PartIdx, CurveIdx, bSplitActor, &SplitCurves.Value.SplitValue });
+			}
+		}
+	}
 
-				UZoneShapeComponent* ZSC = NewZSOutput.CreateOrUpdate(GetNode(), SplitValue, bSplitActor);
+	return Task;
+}
 
-				// We should judge ZoneShapeType first, if is Polygon, then points should have LaneProfile
-				if (!ZoneShapeTypes.IsEmpty())
-					ZSC->SetShapeType((FZoneShapeType)ZoneShapeTypes[FHoudiniOutputUtils::CurveAttributeEntryIdx(ZoneShapeTypeOwner, MainVertexIdx, CurveIdx)]);
+bool FHoudiniZoneShapeOutputTask::Process(const double& EndTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniZoneShapeOutputTask);
 
-				if (!ZoneGraphTags.IsEmpty())
-					ZSC->SetTags(ZoneGraphTags[FHoudiniOutputUtils::CurveAttributeEntryIdx(ZoneShapeTypeOwner, MainVertexIdx, CurveIdx)]);
+	UHoudiniOutputZoneShape* ZSOutput = Output.Get();
+	AHoudiniNode* Node = IsValid(ZSOutput) ? ZSOutput->GetNode() : nullptr;
+	if (!IsValid(Node))  // Output has been removed, nothing to apply
+		Stage = EStage::Finished;
 
-				if (!LaneProfileIndices.IsEmpty())
-				{
-					const int32 LaneProfileIdx = LaneProfileIndices[FHoudiniOutputUtils::CurveAttributeEntryIdx(LaneProfileOwner, MainVertexIdx, CurveIdx)];
-					if (ZoneGraphSettings->GetLaneProfiles().IsValidIndex(LaneProfileIdx))
-						ZSC->SetCommonLaneProfile(ZoneGraphSettings->GetLaneProfiles()[LaneProfileIdx]);
-				}
+	const TArray<FZoneLaneProfile>& LaneProfiles = TransientLaneProfiles ? *TransientLaneProfiles : GetDefault<UZoneGraphSettings>()->GetLaneProfiles();
 
-				TArray<FZoneShapePoint>& Points = ZSC->GetMutablePoints();
-				
-				const int32 StartVertexIdx = ((CurveIdx == 0) ? 0 : VertexIndices[CurveIdx - 1]);
-				const int32 NumCurvePoints = VertexIndices[CurveIdx] - StartVertexIdx;
-				Points.SetNum(NumCurvePoints);
+	struct FStageTimer  // Also counts the stages that return early when out of budget
+	{
+		double& Seconds;
+		const double StartTime = FPlatformTime::Seconds();
+		~FStageTimer() { Seconds += FPlatformTime::Seconds() - StartTime; }
+	};
 
-				ZSC->ClearPerPointLaneProfiles();
+	if (Stage == EStage::BuildPoints)  // Points only depend on the decoded data, so we could build them on worker threads, batch by batch to respect the budget
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputBuildPoints);
+		FStageTimer StageTimer{ StageSeconds[int32(EStage::BuildPoints)] };
 
-				for (int32 PointIdx = 0; PointIdx < NumCurvePoints; ++PointIdx)
+		while (NumBuiltCurves < Curves.Num())
+		{
+			const int32 StartIdx = NumBuiltCurves;
+			const int32 NumBatchCurves = FMath::Min(BuildPointsBatchSize, Curves.Num() - StartIdx);
+			ParallelFor(NumBatchCurves, [&](int32 BatchIdx)
 				{
-					FZoneShapePoint& Point = Points[PointIdx];
-					Point = FZoneShapePoint();  // Reset
-					const int32 GlobalPointIdx = PointIdx + StartVertexIdx;
-					Point.Position = FVector(PositionData[GlobalPointIdx * 3], PositionData[GlobalPointIdx * 3 + 2], PositionData[GlobalPointIdx * 3 + 1]) * POSITION_SCALE_TO_UNREAL;
-					if (!Rots.IsEmpty())
-						Point.Rotation = Rots[FHoudiniOutputUtils::CurveAttributeEntryIdx(RotOwner, GlobalPointIdx, CurveIdx)];
-
-					Point.LaneProfile = FZoneShapePoint::InheritLaneProfile;
-					if (!PointLaneProfileIndices.IsEmpty() && ZSC->GetShapeType() == FZoneShapeType::Polygon)
-					{
-						Point.Type = FZoneShapePointType::LaneProfile;
-						const int32& LaneProfileIdx = PointLaneProfileIndices[GlobalPointIdx];
-						if (ZoneGraphSettings->GetLaneProfiles().IsValidIndex(LaneProfileIdx))
-							Point.LaneProfile = ZSC->AddUniquePerPointLaneProfile(ZoneGraphSettings->GetLaneProfiles()[LaneProfileIdx]);
-					}
+					FCurve& Curve = Curves[StartIdx + BatchIdx];
+					const FHoudiniZoneShapePart& Part = Parts[Curve.PartIdx];
+					const int32 MainVertexIdx = (Curve.CurveIdx == 0) ? 0 : Part.VertexIndices[Curve.CurveIdx - 1];
+					Curve.bIsPolygon = !Part.ZoneShapeTypes.IsEmpty() &&  // Component default is spline
+						(FZoneShapeType(Part.ZoneShapeTypes[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.ZoneShapeTypeOwner, MainVertexIdx, Curve.CurveIdx)]) == FZoneShapeType::Polygon);
+					Part.BuildPoints(Curve.CurveIdx, Curve.bIsPolygon, LaneProfiles, Curve.Points, Curve.PerPointLaneProfileIndices);
+				});
+			NumBuiltCurves += NumBatchCurves;
+
+			if ((NumBuiltCurves < Curves.Num()) && (FPlatformTime::Seconds() >= EndTime))
+				return false;
+		}
 
-					for (const TSharedPtr<FHoudiniAttribute>& PropAttrib : PropAttribs)
-					{
-						const HAPI_AttributeOwner& PropAttribOwner = PropAttrib->GetOwner();
-						if ((PropAttribOwner == HAPI_ATTROWNER_VERTEX) || (PropAttribOwner == HAPI_ATTROWNER_POINT))
-							PropAttrib->SetStructPropertyValues(&Point, FZoneShapePoint::StaticStruct(),
-								FHoudiniOutputUtils::CurveAttributeEntryIdx(PropAttribOwner, GlobalPointIdx, CurveIdx));
-					}
-				}
+		Stage = EStage::Apply;
+	}
 
-				// Set UProperties
-				for (const TSharedPtr<FHoudiniAttribute>& PropAttrib : PropAttribs)
-				{
-					const HAPI_AttributeOwner& PropAttribOwner = PropAttrib->GetOwner();
-					if ((PropAttribOwner == HAPI_ATTROWNER_PRIM) || (PropAttribOwner == HAPI_ATTROWNER_DETAIL))
-						PropAttrib->SetObjectPropertyValues(ZSC, FHoudiniOutputUtils::CurveAttributeEntryIdx(PropAttribOwner, MainVertexIdx, CurveIdx));
-				}
-				SET_SPLIT_ACTOR_UPROPERTIES(NewZSOutput, FHoudiniOutputUtils::CurveAttributeEntryIdx(PropAttribOwner, MainVertexIdx, CurveIdx), false);
-				
+	if (Stage == EStage::Apply)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputApply);
+		FStageTimer StageTimer{ StageSeconds[int32(EStage::Apply)] };
+
+
+		FArrayProperty* ShapeConnectorsProp = CastField<FArrayProperty>(UZoneShapeComponent::StaticClass()->FindPropertyByName("ShapeConnectors"));
+		FArrayProperty* ConnectedShapesProp = CastField<FArrayProperty>(UZoneShapeComponent::StaticClass()->FindPropertyByName("ConnectedShapes"));
+
+		FZoneShapeComponentSnapshot ZSCSnapshot;
+
+		while (NumAppliedCurves < Curves.Num())
+		{
+			FCurve& Curve = Curves[NumAppliedCurves];
+			++NumAppliedCurves;
+
+			const FHoudiniZoneShapePart& Part = Parts[Curve.PartIdx];
+			const int32& CurveIdx = Curve.CurveIdx;
+			const TArray<int32>& VertexIndices = Part.VertexIndices;
+			const TArray<TSharedPtr<FHoudiniAttribute>>& PropAttribs = Part.PropAttribs;
+			const int32 MainVertexIdx = (CurveIdx == 0) ? 0 : VertexIndices[CurveIdx - 1];
+
+			if (!ZSOutput->ZoneShapeOutputs.IsValidIndex(Curve.OutputIdx))  // Holders have been restored by undo/redo
+				continue;
+
+			FHoudiniZoneShapeOutput& NewZSOutput = ZSOutput->ZoneShapeOutputs[Curve.OutputIdx];
+			const UZoneShapeComponent* OldZSC = NewZSOutput.Find(Node);
+			UZoneShapeComponent* ZSC = NewZSOutput.CreateOrUpdate(Node, *Curve.SplitValue, Curve.bSplitActor);
+			const bool bIsNewZSC = (OldZSC != ZSC);
+			const bool bCompareSnapshot = !bIsNewZSC && !Part.bHasUnknownComponentProperties;
+			if (bCompareSnapshot)
+				ZSCSnapshot.Capture(ZSC, Part.ComponentProperties);
+
+			// We should judge ZoneShapeType first, if is Polygon, then points should have LaneProfile
+			if (!Part.ZoneShapeTypes.IsEmpty())
+				ZSC->SetShapeType((FZoneShapeType)Part.ZoneShapeTypes[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.ZoneShapeTypeOwner, MainVertexIdx, CurveIdx)]);
+
+			if (!Part.ZoneGraphTags.IsEmpty())
+				ZSC->SetTags(Part.ZoneGraphTags[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.ZoneGraphTagOwner, MainVertexIdx, CurveIdx)]);
+
+			if (!Part.LaneProfileIndices.IsEmpty())
+			{
+				const int32 LaneProfileIdx = Part.LaneProfileIndices[FHoudiniOutputUtils::CurveAttributeEntryIdx(Part.LaneProfileOwner, MainVertexIdx, CurveIdx)];
+				if (LaneProfiles.IsValidIndex(LaneProfileIdx))
+					ZSC->SetCommonLaneProfile(LaneProfiles[LaneProfileIdx]);
+			}
+
+			// Shape type may come from the reused component, then points should be rebuilt for it
+			const bool bIsPolygon = (ZSC->GetShapeType() == FZoneShapeType::Polygon);
+			if (bIsPolygon != Curve.bIsPolygon)
+				Part.BuildPoints(CurveIdx, bIsPolygon, LaneProfiles, Curve.Points, Curve.PerPointLaneProfileIndices);
+
+			ZSC->ClearPerPointLaneProfiles();
+			TArray<uint8, TInlineAllocator<8>> PerPointLaneProfileMap;  // Index of Curve.PerPointLaneProfileIndices -> Index of ZSC PerPointLaneProfiles
+			for (const int32& LaneProfileIdx : Curve.PerPointLaneProfileIndices)
+				PerPointLaneProfileMap.Add(ZSC->AddUniquePerPointLaneProfile(LaneProfiles[LaneProfileIdx]));
+
+			TArray<FZoneShapePoint>& Points = ZSC->GetMutablePoints();
+			Points = MoveTemp(Curve.Points);
+			Curve.PerPointLaneProfileIndices.Empty();
+
+			// Most point attributes have been compiled to Part.PointPropSetters and set in BuildPoints, here only the rest
+			TArray<FHoudiniAttribute*, TInlineAllocator<4>> PointPropAttribs;
+			for (const TSharedPtr<FHoudiniAttribute>& PropAttrib : PropAttribs)
+			{
+				const HAPI_AttributeOwner& PropAttribOwner = PropAttrib->GetOwner();
+				if ((PropAttribOwner == HAPI_ATTROWNER_VERTEX) || (PropAttribOwner == HAPI_ATTROWNER_POINT))
+					PointPropAttribs.Add(PropAttrib.Get());
+			}
+
+			const int32& StartVertexIdx = MainVertexIdx;
+			for (int32 PointIdx = 0; PointIdx < Points.Num(); ++PointIdx)
+			{
+				FZoneShapePoint& Point = Points[PointIdx];
+				if (Point.LaneProfile != FZoneShapePoint::InheritLaneProfile)
+					Point.LaneProfile = PerPointLaneProfileMap[Point.LaneProfile];
+
+				const int32 GlobalPointIdx = PointIdx + StartVertexIdx;
+				for (FHoudiniAttribute* PointPropAttrib : PointPropAttribs)
+					PointPropAttrib->SetStructPropertyValues(&Point, FZoneShapePoint::StaticStruct(),
+						FHoudiniOutputUtils::CurveAttributeEntryIdx(PointPropAttrib->GetOwner(), GlobalPointIdx, CurveIdx));
+			}
+
+			// Set UProperties
+			for (const TSharedPtr<FHoudiniAttribute>& PropAttrib : PropAttribs)
+			{
+				const HAPI_AttributeOwner& PropAttribOwner = PropAttrib->GetOwner();
+				if ((PropAttribOwner == HAPI_ATTROWNER_PRIM) || (PropAttribOwner == HAPI_ATTROWNER_DETAIL))
+					PropAttrib->SetObjectPropertyValues(ZSC, FHoudiniOutputUtils::CurveAttributeEntryIdx(PropAttribOwner, MainVertexIdx, CurveIdx));
+			}
+			SET_SPLIT_ACTOR_UPROPERTIES(NewZSOutput, FHoudiniOutputUtils::CurveAttributeEntryIdx(PropAttribOwner, MainVertexIdx, CurveIdx), false);
+
+			// Skip the unchanged ZSCs, so that no shape rebuild, no undo record and no dirtied package
+			if (!bCompareSnapshot || !ZSCSnapshot.Equals(ZSC))
+			{
 				// Avoid Crash when ZSC create scene proxy
 				if (ShapeConnectorsProp && ConnectedShapesProp)
 				{
@@ -796,41 +1996,79 @@ bool UHoudiniOutputZoneShape::HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArr
 				}
 
 				ChangedZSCs.Add(ZSC);
-
-				NewZoneShapeOutputs.Add(NewZSOutput);
 			}
+
+			if (FPlatformTime::Seconds() >= EndTime)
+				return false;
 		}
+
+		Stage = EStage::DestroyOld;
 	}
 
-	// -------- Post-processing --------
-	if (bZoneGraphSettingsModified)
-		ZoneGraphSettings->TryUpdateDefaultConfigFile();
+	if (Stage == EStage::DestroyOld)  // We should update shapes after useless ZSCs has been destroyed
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputDestroy);
+		FStageTimer StageTimer{ StageSeconds[int32(EStage::DestroyOld)] };
 
-	// Destroy old outputs, like this->Destroy()
-	for (const FHoudiniZoneShapeOutput* OldZSOutput : OldZoneShapeOutputs)
-		OldZSOutput->Destroy(Node);
-	OldZoneShapeOutputs.Empty();
+		FHoudiniZoneShapeSpatialIndex& SpatialIndex = FHoudiniMassTranslator::Get().GetZoneShapeSpatialIndex();
+		for (const FHoudiniZoneShapeOutput& OldZSOutput : OldOutputs)
+		{
+			const UZoneShapeComponent* OldZSC = OldZSOutput.Find(Node);
+			OldZSOutput.Destroy(Node);
+			if (OldZSC)  // Has been destroyed, so will be removed from the index
+				SpatialIndex.Update(OldZSC);
+		}
+		OldOutputs.Empty();
 
-	// Update output holders
-	ZoneShapeOutputs = NewZoneShapeOutputs;
+		Stage = EStage::UpdateShape;
+	}
 
-	// We should update shapes after useless ZSCs has been destroyed
-	for (UZoneShapeComponent* ZSC : ChangedZSCs)
+	if (Stage == EStage::UpdateShape)
 	{
-		ZSC->UpdateShape();
-		ZSC->Modify();
-	}
+		SCOPE_CYCLE_COUNTER(STAT_HoudiniMass_OutputUpdateShape);
+		FStageTimer StageTimer{ StageSeconds[int32(EStage::UpdateShape)] };
 
-	if (!ChangedZSCs.IsEmpty())
-		AsyncTask(ENamedThreads::GameThread, [] { FHoudiniMassTranslator::Get().OnZoneShapeOutputFinish(); });  // After all outputs finished
+		FHoudiniZoneShapeSpatialIndex& SpatialIndex = FHoudiniMassTranslator::Get().GetZoneShapeSpatialIndex();  // Components may be created on exist actors, which will NOT be notified by editor delegates
+		while (NumUpdatedShapes < ChangedZSCs.Num())
+		{
+			if (UZoneShapeComponent* ZSC = ChangedZSCs[NumUpdatedShapes].Get())
+			{
+				ZSC->UpdateShape();
+				ZSC->Modify();
+				SpatialIndex.Update(ZSC);
+			}
+			++NumUpdatedShapes;
+
+			if (FPlatformTime::Seconds() >= EndTime)
+				return false;
+		}
+
+		Stage = EStage::Finished;
+	}
 
 	return true;
 }
 
-void UHoudiniOutputZoneShape::Destroy() const
+void FHoudiniZoneShapeOutputTask::Cancel(const AHoudiniNode* Node)
 {
-	for (const FHoudiniZoneShapeOutput& OldZoneShapeOutput : ZoneShapeOutputs)
-		OldZoneShapeOutput.Destroy(GetNode());
+	for (const FHoudiniZoneShapeOutput& OldZSOutput : OldOutputs)
+		OldZSOutput.Destroy(Node);
+	OldOutputs.Empty();
+	ChangedZSCs.Empty();  // Components will be destroyed, so no need to build zone graph
+
+	Stage = EStage::Finished;
+}
+
+float FHoudiniZoneShapeOutputTask::GetProgress() const
+{
+	if (Stage == EStage::Finished)
+		return 1.0f;
+
+	// BuildPoints, Apply and UpdateShape take a third each
+	const float BuildProgress = Curves.IsEmpty() ? 1.0f : float(NumBuiltCurves) / float(Curves.Num());
+	const float ApplyProgress = Curves.IsEmpty() ? 1.0f : float(NumAppliedCurves) / float(Curves.Num());
+	const float UpdateProgress = (Stage != EStage::UpdateShape) || ChangedZSCs.IsEmpty() ? 0.0f : float(NumUpdatedShapes) / float(ChangedZSCs.Num());
+	return (BuildProgress + ApplyProgress + UpdateProgress) / 3.0f;
 }
 
 void UHoudiniOutputZoneShape::CollectActorSplitValues(TSet<FString>& InOutSplitValues, TSet<FString>& InOutEditableSplitValues) const
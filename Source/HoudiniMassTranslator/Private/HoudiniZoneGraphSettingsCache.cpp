@@ -0,0 +1,205 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniZoneGraphSettingsCache.h"
+
+#include "ZoneGraphSettings.h"
+
+#include "HoudiniEngine.h"
+#include "HoudiniEngineUtils.h"
+
+
+static void AppendEncoding(TArray<ANSICHAR>& OutEncoding, const FString& Str)
+{
+	const FTCHARToUTF8 Utf8Str(*Str);
+	OutEncoding.Append(Utf8Str.Get(), Utf8Str.Length());
+	OutEncoding.Add('\0');
+}
+
+void FHoudiniZoneGraphSettingsCache::Refresh(const UZoneGraphSettings* ZoneGraphSettings)
+{
+	FName NewTagNames[MaxTags];
+	for (const FZoneGraphTagInfo& TagInfo : ZoneGraphSettings->GetTagInfos())
+	{
+		if (TagInfo.IsValid() && (TagInfo.Tag.Get() < MaxTags))
+			NewTagNames[TagInfo.Tag.Get()] = TagInfo.Name;
+	}
+
+	bool bTagsChanged = false;
+	for (int32 TagBit = 0; TagBit < MaxTags; ++TagBit)
+	{
+		if (TagNames[TagBit] != NewTagNames[TagBit])
+		{
+			TagNames[TagBit] = NewTagNames[TagBit];
+			bTagsChanged = true;
+		}
+	}
+
+	if (bTagsChanged)  // Lane encodings contain tag names, so we should re-encode them
+	{
+		LaneEncodingIdxMap.Empty();
+		LaneEncodings.Empty();
+	}
+}
+
+int32 FHoudiniZoneGraphSettingsCache::FindOrAddLaneEncoding(const FZoneLaneDesc& Lane)
+{
+	if (const int32* FoundEncodingIdxPtr = LaneEncodingIdxMap.Find(Lane))
+		return *FoundEncodingIdxPtr;
+
+	FString TagsStr;
+	for (int32 TagBit = 0; TagBit < MaxTags; ++TagBit)
+	{
+		if (!TagNames[TagBit].IsNone() && (Lane.Tags.GetValue() & (1u << TagBit)))
+			TagsStr += (TagsStr.IsEmpty() ? TEXT("\"") : TEXT(",\"")) + TagNames[TagBit].ToString() + TEXT("\"");
+	}
+
+	const int32 NewEncodingIdx = LaneEncodings.AddDefaulted();
+	AppendEncoding(LaneEncodings[NewEncodingIdx], FString::Printf(TEXT("{\"Width\":%f,\"Direction\":%d,\"Tags\":[%s]}"),
+		Lane.Width * POSITION_SCALE_TO_HOUDINI, int32(Lane.Direction), *TagsStr));
+	LaneEncodingIdxMap.Add(Lane, NewEncodingIdx);
+
+	return NewEncodingIdx;
+}
+
+int32 FHoudiniZoneGraphSettingsCache::FindOrAddNameEncoding(const FName& Name)
+{
+	if (const int32* FoundEncodingIdxPtr = NameEncodingIdxMap.Find(Name))
+		return *FoundEncodingIdxPtr;
+
+	const int32 NewEncodingIdx = NameEncodings.AddDefaulted();
+	AppendEncoding(NameEncodings[NewEncodingIdx], Name.IsNone() ? FString() : Name.ToString());
+	NameEncodingIdxMap.Add(Name, NewEncodingIdx);
+
+	return NewEncodingIdx;
+}
+
+bool FHoudiniZoneGraphSettingsCache::IsLaneProfileEquivalent(const TArray<FZoneLaneDesc>& A, const TArray<FZoneLaneDesc>& B)
+{
+	if (A.Num() != B.Num())
+		return false;
+
+	for (int32 LaneIdx = 0; LaneIdx < A.Num(); ++LaneIdx)
+	{
+		if (!IsLaneEquivalent(A[LaneIdx], B[LaneIdx]))
+			return false;
+	}
+
+	return true;
+}
+
+void FHoudiniZoneGraphSettingsCache::UpdateLaneProfileIndex(const UZoneGraphSettings* ZoneGraphSettings)
+{
+	const TArray<FZoneLaneProfile>& LaneProfiles = ZoneGraphSettings->GetLaneProfiles();
+	if (LaneProfiles.Num() < NumIndexedProfiles)  // Some lane profiles have been removed, so we should rebuild the index
+		InvalidateLaneProfiles();
+
+	for (int32 ProfileIdx = NumIndexedProfiles; ProfileIdx < LaneProfiles.Num(); ++ProfileIdx)
+	{
+		HashProfileIdxMap.Add(GetLaneProfileHash(LaneProfiles[ProfileIdx].Lanes), ProfileIdx);
+		NameProfileIdxMap.FindOrAdd(LaneProfiles[ProfileIdx].Name, ProfileIdx);
+	}
+	NumIndexedProfiles = LaneProfiles.Num();
+}
+
+int32 FHoudiniZoneGraphSettingsCache::FindLaneProfile(const UZoneGraphSettings* ZoneGraphSettings, const TArray<FZoneLaneDesc>& Lanes, const uint32& LanesHash)
+{
+	UpdateLaneProfileIndex(ZoneGraphSettings);
+
+	const TArray<FZoneLaneProfile>& LaneProfiles = ZoneGraphSettings->GetLaneProfiles();
+	for (int32 Attempt = 0; Attempt < 2; ++Attempt)
+	{
+		bool bIsIndexOutdated = false;
+		for (TMultiMap<uint32, int32>::TConstKeyIterator ProfileIter(HashProfileIdxMap, LanesHash); ProfileIter; ++ProfileIter)
+		{
+			const int32& ProfileIdx = ProfileIter.Value();
+			if (!LaneProfiles.IsValidIndex(ProfileIdx) || (GetLaneProfileHash(LaneProfiles[ProfileIdx].Lanes) != LanesHash))  // Lane profiles have been edited or reordered
+			{
+				bIsIndexOutdated = true;
+				break;
+			}
+
+			if (IsLaneProfileEquivalent(LaneProfiles[ProfileIdx].Lanes, Lanes))
+				return ProfileIdx;
+		}
+
+		if (!bIsIndexOutdated)
+			break;
+
+		InvalidateLaneProfiles();
+		UpdateLaneProfileIndex(ZoneGraphSettings);
+	}
+
+	return INDEX_NONE;
+}
+
+int32 FHoudiniZoneGraphSettingsCache::AddLaneProfile(UZoneGraphSettings* ZoneGraphSettings, const FZoneLaneProfile& NewLaneProfile)
+{
+	UpdateLaneProfileIndex(ZoneGraphSettings);
+
+	const int32 NewProfileIdx = ((TArray<FZoneLaneProfile>*)&ZoneGraphSettings->GetLaneProfiles())->Add(NewLaneProfile);
+	HashProfileIdxMap.Add(GetLaneProfileHash(NewLaneProfile.Lanes), NewProfileIdx);
+	NameProfileIdxMap.FindOrAdd(NewLaneProfile.Name, NewProfileIdx);
+	NumIndexedProfiles = NewProfileIdx + 1;
+
+	return NewProfileIdx;
+}
+
+int32 FHoudiniZoneGraphSettingsCache::FindLaneProfileByName(const UZoneGraphSettings* ZoneGraphSettings, const FName& LaneProfileName)
+{
+	if (LaneProfileName.IsNone())
+		return INDEX_NONE;
+
+	UpdateLaneProfileIndex(ZoneGraphSettings);
+
+	const TArray<FZoneLaneProfile>& LaneProfiles = ZoneGraphSettings->GetLaneProfiles();
+	const int32* FoundProfileIdxPtr = NameProfileIdxMap.Find(LaneProfileName);
+	if (!FoundProfileIdxPtr)
+		return INDEX_NONE;
+
+	if (LaneProfiles.IsValidIndex(*FoundProfileIdxPtr) && (LaneProfiles[*FoundProfileIdxPtr].Name == LaneProfileName))
+		return *FoundProfileIdxPtr;
+
+	// Lane profiles have been renamed or reordered, so we should rebuild the index
+	InvalidateLaneProfiles();
+	UpdateLaneProfileIndex(ZoneGraphSettings);
+	FoundProfileIdxPtr = NameProfileIdxMap.Find(LaneProfileName);
+	return FoundProfileIdxPtr ? *FoundProfileIdxPtr : INDEX_NONE;
+}
+
+FZoneGraphTagMask FHoudiniZoneGraphSettingsCache::FindOrCreateTag(UZoneGraphSettings* ZoneGraphSettings, const FName& TagName, bool& bZoneGraphSettingsModified)
+{
+	TConstArrayView<FZoneGraphTagInfo> ConstTagInfos = ZoneGraphSettings->GetTagInfos();
+	TArrayView<FZoneGraphTagInfo> TagInfos = *((TArrayView<FZoneGraphTagInfo>*)&ConstTagInfos);
+
+	// First, try find the tag by name
+	if (const uint8* FoundTagBitPtr = NameTagMap.Find(TagName))
+	{
+		if (TagInfos.IsValidIndex(*FoundTagBitPtr) && (TagInfos[*FoundTagBitPtr].Name == TagName))
+			return TagInfos[*FoundTagBitPtr].Tag;
+	}
+
+	NameTagMap.Empty();  // Not found or outdated, so re-index all tags
+	for (const FZoneGraphTagInfo& TagInfo : TagInfos)
+	{
+		if (TagInfo.IsValid())
+			NameTagMap.FindOrAdd(TagInfo.Name, TagInfo.Tag.Get());
+	}
+
+	if (const uint8* FoundTagBitPtr = NameTagMap.Find(TagName))
+		return TagInfos[*FoundTagBitPtr].Tag;
+
+	// Second, try find tag that is invalid (name is none) and set name, as a created tag
+	for (FZoneGraphTagInfo& TagInfo : TagInfos)
+	{
+		if (!TagInfo.IsValid())
+		{
+			TagInfo.Name = TagName;
+			NameTagMap.Add(TagName, TagInfo.Tag.Get());
+			bZoneGraphSettingsModified = true;
+			return TagInfo.Tag;
+		}
+	}
+
+	UE_LOG(LogHoudiniEngine, Error, TEXT("Cannot create zone graph tag: %s"), *TagName.ToString());
+	return FZoneGraphTagMask(1);
+}
@@ -0,0 +1,20 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniZoneShapeRegion.h"
+
+
+UHoudiniZoneShapeRegionComponent::UHoudiniZoneShapeRegionComponent()
+{
+	BoxExtent = FVector(5000.0, 5000.0, 1000.0);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	bIsEditorOnly = true;
+	bHiddenInGame = true;
+}
+
+AHoudiniZoneShapeRegion::AHoudiniZoneShapeRegion()
+{
+	Region = CreateDefaultSubobject<UHoudiniZoneShapeRegionComponent>(TEXT("Region"));
+	RootComponent = Region;
+	bIsEditorOnlyActor = true;
+}
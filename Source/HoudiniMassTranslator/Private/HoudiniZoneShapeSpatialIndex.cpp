@@ -0,0 +1,201 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#include "HoudiniZoneShapeSpatialIndex.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "ZoneGraphSettings.h"
+#include "ZoneShapeComponent.h"
+
+
+void FHoudiniZoneShapeSpatialIndex::Initialize()
+{
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnActorChanged);
+		GEngine->OnLevelActorDeleted().AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnActorChanged);
+		GEngine->OnActorMoved().AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnActorMoved);
+	}
+	FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnLevelChanged);
+	FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnLevelChanged);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FHoudiniZoneShapeSpatialIndex::OnObjectPropertyChanged);
+}
+
+void FHoudiniZoneShapeSpatialIndex::Deinitialize()
+{
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().RemoveAll(this);
+		GEngine->OnLevelActorDeleted().RemoveAll(this);
+		GEngine->OnActorMoved().RemoveAll(this);
+	}
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	FWorldDelegates::LevelRemovedFromWorld.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+
+	Entries.Empty();
+	FreeEntryIndices.Empty();
+	ComponentEntryIdxMap.Empty();
+	Cells.Empty();
+	bDirty = true;
+}
+
+FBox FHoudiniZoneShapeSpatialIndex::GetBounds(const UZoneShapeComponent* ZSC, const FTransform& Transform)
+{
+	// Bezier segments lie in the convex hull of their control points
+	FBox Box(ForceInit);
+	for (const FZoneShapePoint& Point : ZSC->GetPoints())
+	{
+		Box += Transform.TransformPosition(Point.Position);
+		if (Point.Type != FZoneShapePointType::Sharp)
+		{
+			Box += Transform.TransformPosition(Point.GetInControlPoint());
+			Box += Transform.TransformPosition(Point.GetOutControlPoint());
+		}
+	}
+
+	if (!Box.IsValid)
+		return Box;
+
+	// Lanes extend half the profile width on each side of the curve, lane widths are NOT scaled by the component
+	const UZoneGraphSettings* ZoneGraphSettings = GetDefault<UZoneGraphSettings>();
+	double MaxLanesWidth = 0.0;
+	auto AccumulateLaneProfileLambda = [&](const FZoneLaneProfileRef& LaneProfileRef)
+		{
+			if (const FZoneLaneProfile* LaneProfile = ZoneGraphSettings->GetLaneProfileByRef(LaneProfileRef))
+				MaxLanesWidth = FMath::Max(MaxLanesWidth, double(LaneProfile->GetLanesTotalWidth()));
+		};
+
+	AccumulateLaneProfileLambda(ZSC->GetCommonLaneProfile());
+	for (const FZoneLaneProfileRef& LaneProfileRef : ZSC->GetPerPointLaneProfiles())
+		AccumulateLaneProfileLambda(LaneProfileRef);
+
+	return Box.ExpandBy(MaxLanesWidth * 0.5 * FMath::Max(Transform.GetMaximumAxisScale(), 1.0));  // Conservative when Transform is relative to a scaled space
+}
+
+FBox FHoudiniZoneShapeSpatialIndex::GetWorldBounds(const UZoneShapeComponent* ZSC)
+{
+	return GetBounds(ZSC, ZSC->GetComponentTransform());
+}
+
+void FHoudiniZoneShapeSpatialIndex::AddEntry(const UZoneShapeComponent* ZSC)
+{
+	const FBox Bounds = GetWorldBounds(ZSC);
+	if (!Bounds.IsValid)
+		return;
+
+	const int32 EntryIdx = FreeEntryIndices.IsEmpty() ? Entries.AddDefaulted() : FreeEntryIndices.Pop();
+	Entries[EntryIdx].Component = ZSC;
+	Entries[EntryIdx].Bounds = Bounds;
+	ComponentEntryIdxMap.Add(ZSC, EntryIdx);
+	ForEachCell(Bounds, [&](const FIntPoint& Cell) { Cells.FindOrAdd(Cell).Add(EntryIdx); });
+}
+
+void FHoudiniZoneShapeSpatialIndex::RemoveEntry(const int32& EntryIdx)
+{
+	FEntry& Entry = Entries[EntryIdx];
+	ForEachCell(Entry.Bounds, [&](const FIntPoint& Cell)
+		{
+			if (TArray<int32>* CellEntryIndices = Cells.Find(Cell))
+			{
+				CellEntryIndices->RemoveSingleSwap(EntryIdx);
+				if (CellEntryIndices->IsEmpty())
+					Cells.Remove(Cell);
+			}
+		});
+
+	Entry.Component.Reset();
+	Entry.Bounds.Init();
+	FreeEntryIndices.Add(EntryIdx);
+}
+
+void FHoudiniZoneShapeSpatialIndex::Rebuild(const UWorld* World)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(HoudiniZoneShapeSpatialIndexRebuild);
+
+	Entries.Reset();
+	FreeEntryIndices.Reset();
+	ComponentEntryIdxMap.Reset();
+	Cells.Reset();
+
+	for (TObjectIterator<UZoneShapeComponent> Iter; Iter; ++Iter)
+	{
+		const UZoneShapeComponent* ZSC = *Iter;
+		if (IsValid(ZSC) && !ZSC->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && (ZSC->GetWorld() == World))
+			AddEntry(ZSC);
+	}
+
+	IndexedWorld = World;
+	bDirty = false;
+}
+
+void FHoudiniZoneShapeSpatialIndex::Update(const UZoneShapeComponent* ZSC)
+{
+	if (bDirty || (ZSC->GetWorld() != IndexedWorld.Get()))  // Will be indexed when rebuild
+		return;
+
+	if (const int32* FoundEntryIdxPtr = ComponentEntryIdxMap.Find(ZSC))
+	{
+		RemoveEntry(*FoundEntryIdxPtr);
+		ComponentEntryIdxMap.Remove(ZSC);
+	}
+
+	if (IsValid(ZSC))
+		AddEntry(ZSC);
+}
+
+void FHoudiniZoneShapeSpatialIndex::Query(const UWorld* World, const FBox& WorldBox, TArray<const UZoneShapeComponent*>& OutComponents)
+{
+	if (bDirty || (World != IndexedWorld.Get()))
+		Rebuild(World);
+
+	TSet<int32> VisitedEntryIndices;
+	ForEachCell(WorldBox, [&](const FIntPoint& Cell)
+		{
+			const TArray<int32>* CellEntryIndices = Cells.Find(Cell);
+			if (!CellEntryIndices)
+				return;
+
+			for (const int32& EntryIdx : *CellEntryIndices)
+			{
+				bool bIsAlreadyVisited = false;
+				VisitedEntryIndices.Add(EntryIdx, &bIsAlreadyVisited);
+				if (bIsAlreadyVisited)
+					continue;
+
+				const FEntry& Entry = Entries[EntryIdx];
+				const UZoneShapeComponent* ZSC = Entry.Component.Get();
+				if (IsValid(ZSC) && Entry.Bounds.Intersect(WorldBox))
+					OutComponents.Add(ZSC);
+			}
+		});
+}
+
+void FHoudiniZoneShapeSpatialIndex::OnActorChanged(AActor* Actor)
+{
+	if (Actor && Actor->FindComponentByClass<UZoneShapeComponent>())
+		MarkDirty();
+}
+
+void FHoudiniZoneShapeSpatialIndex::OnActorMoved(AActor* Actor)
+{
+	if (!Actor)
+		return;
+
+	TInlineComponentArray<UZoneShapeComponent*> ZSCs(Actor);
+	for (const UZoneShapeComponent* ZSC : ZSCs)
+		Update(ZSC);
+}
+
+void FHoudiniZoneShapeSpatialIndex::OnLevelChanged(ULevel*, UWorld*)
+{
+	MarkDirty();
+}
+
+void FHoudiniZoneShapeSpatialIndex::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent&)
+{
+	if (const UZoneShapeComponent* ZSC = Cast<UZoneShapeComponent>(Object))  // Points have been edited
+		Update(ZSC);
+	else if (AActor* Actor = Cast<AActor>(Object))  // Components may be added or removed
+		OnActorChanged(Actor);
+}
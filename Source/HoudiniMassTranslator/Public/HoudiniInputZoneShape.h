@@ -2,13 +2,68 @@
 
 #pragma once
 
+#include "ZoneGraphTypes.h"
+
 #include "HoudiniInput.h"
 
 
+class FHoudiniZoneGraphSettingsCache;
+
+// Flat buffers of zone shapes with the same layout as we upload, could be gathered without a houdini session
+struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapesInputData
+{
+	int32 NumPoints = 0;
+	bool bHasPolygon = false;
+	bool bHasSpline = false;
+
+	TArray<int32> VertexCounts;
+	TArray<int32> ZoneShapeTypes;
+	TArray<float> Positions;  // Houdini space, 3 floats per point
+	TArray<float> Rotations;  // Houdini space, 4 floats per point
+
+	// s@unreal_zone_lane_profile_name
+	TArray<FName> PointLaneProfileNames;
+	TArray<FName> SplineLaneProfileNames;
+
+	// d[]@unreal_zone_lane_profile
+	TArray<FZoneLaneDesc> PointLanes;
+	TArray<int32> PointLaneCounts;
+	TArray<FZoneLaneDesc> SplineLanes;
+	TArray<int32> SplineLaneCounts;
+
+	// i@unreal_zone_shape_connector, i@unreal_zone_shape_connected_prim, i@unreal_zone_shape_connected_connector, s@unreal_zone_shape_connector_lane_profile
+	int32 NumConnectors = 0;
+	TArray<int32> PointConnectors;
+	TArray<int32> PointConnectedPrims;  // Only the shapes gathered together have prim indices
+	TArray<int32> PointConnectedConnectors;
+	TArray<FName> PointConnectorLaneProfileNames;
+
+	// Encoded strs, owned by FHoudiniZoneGraphSettingsCache
+	TArray<const char*> PointLaneProfileNamePtrs;
+	TArray<const char*> SplineLaneProfileNamePtrs;
+	TArray<const char*> PointLanePtrs;
+	TArray<const char*> SplineLanePtrs;
+	TArray<const char*> PointConnectorLaneProfileNamePtrs;
+
+	void Gather(const TArray<const UActorComponent*>& Components, const TArray<FTransform>& Transforms, const TArray<int32>& ComponentIndices);  // Parallel
+
+	void Encode(FHoudiniZoneGraphSettingsCache& SettingsCache);  // Should refresh the SettingsCache first
+};
+
+
+struct FHoudiniZoneShapeInputBucket
+{
+	int32 NodeId = -1;
+
+	TArray<uint32> ComponentHashes;  // Content hash of each uploaded component, used to skip uploading when nothing changed
+};
+
 class HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeComponentInput : public FHoudiniComponentInput
 {
 public:
-	int32 NodeId = -1;
+	uint32 SettingsHash = 0;  // Hash of the lane profiles and tags in UZoneGraphSettings, json lanes we uploaded depend on them
+
+	TMap<uint64, FHoudiniZoneShapeInputBucket> Buckets;  // Each bucket has its own node under the merge, see EHoudiniZoneShapeInputNodeMode
 
 	virtual void Invalidate() const override {}  // Will then delete this, so we need NOT to reset node ids to -1
 
@@ -0,0 +1,85 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "UObject/Object.h"
+
+#include "HoudiniLaneProfileRegistry.generated.h"
+
+
+class AActor;
+
+USTRUCT()
+struct HOUDINIMASSTRANSLATOR_API FHoudiniLaneProfileReferences  // Houdini lane profiles used by the shapes of a split value
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FString SplitValue;
+
+	UPROPERTY(Config)
+	TArray<FGuid> LaneProfileIDs;  // Sorted
+
+	FORCEINLINE bool operator==(const FHoudiniLaneProfileReferences& Other) const
+	{
+		return (SplitValue == Other.SplitValue) && (LaneProfileIDs == Other.LaneProfileIDs);
+	}
+};
+
+USTRUCT()
+struct HOUDINIMASSTRANSLATOR_API FHoudiniLaneProfileOwner  // An output that references houdini lane profiles
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FString Key;  // "<Node actor guid>|<Output name>", stable when the node actor is renamed or moved
+
+	UPROPERTY(Config)
+	FString PackageName;  // Where the output is saved, the owner will be pruned once the package no longer exists
+
+	UPROPERTY(Config)
+	TArray<FHoudiniLaneProfileReferences> References;
+};
+
+// Records which houdini outputs reference each houdini lane profile (starts with "LP_HE_"), so that cleanup only walks the lane profiles,
+// and keeps the ones used by unloaded levels, game thread only.
+// Outputs keep their own references, and re-register them when cooked, loaded, undone or redone, the registry is only written into
+// DefaultEditor.ini when a package that has outputs is saved, or by the cleanup commands, so that config is NOT rewritten on every cook
+UCLASS(Config = Editor, DefaultConfig)
+class HOUDINIMASSTRANSLATOR_API UHoudiniLaneProfileRegistry : public UObject
+{
+	GENERATED_BODY()
+
+protected:
+	UPROPERTY(Config)
+	TArray<FHoudiniLaneProfileOwner> Owners;  // Sorted by key, each owner is a line in config, only synced from OwnerMap when saving
+
+	TMap<FString, FHoudiniLaneProfileOwner> OwnerMap;  // Key -> Owner
+
+	TMap<FGuid, int32> RefCounts;  // Derived from OwnerMap
+
+	bool bLoaded = false;
+
+	bool bModified = false;
+
+	void Load();  // Build OwnerMap and RefCounts from config
+
+	void AddRefCounts(const TArray<FHoudiniLaneProfileReferences>& References, const int32& Delta);
+
+public:
+	FORCEINLINE static UHoudiniLaneProfileRegistry* Get() { return GetMutableDefault<UHoudiniLaneProfileRegistry>(); }
+
+	static FString GetOwnerKey(const AActor* Node, const UObject* Output);
+
+	void SetReferences(const AActor* Node, const UObject* Output, const TArray<FHoudiniLaneProfileReferences>& References);  // Empty References will remove the owner
+
+	void RemoveReferences(const AActor* Node, const UObject* Output);
+
+	void Prune();  // Remove the owners whose packages have been deleted, renamed or moved
+
+	bool IsReferenced(const FGuid& LaneProfileID);
+
+	void Empty();
+
+	void SaveIfModified();
+};
@@ -2,9 +2,46 @@
 
 #pragma once
 
+#include "Stats/Stats.h"
+
 #define HOUDINI_LANE_PROFILE_PREFIX                  TEXT("LP_HE_")
 #define HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_SHAPE         "unreal_output_zone_shape"
 #define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TYPE           "unreal_zone_shape_type"  // both int and string are supported
 #define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_TAGS           "unreal_zone_shape_tags"
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_ID             "unreal_zone_shape_id"   // i@unreal_zone_shape_id, optional stable id, curves will bind back to the zone shape with the same id
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CLIPPED        "unreal_zone_shape_clipped"   // i@unreal_zone_shape_clipped on prim, input only, the shape crosses the boundary of the Houdini Zone Shape Region
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTOR      "unreal_zone_shape_connector"   // i@unreal_zone_shape_connector on point, input only, index of the shape connector at this point, -1 if none
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTED_PRIM "unreal_zone_shape_connected_prim"   // i@unreal_zone_shape_connected_prim on point, input only, prim index of the connected shape in the same node, -1 if none
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTED_CONNECTOR "unreal_zone_shape_connected_connector"   // i@unreal_zone_shape_connected_connector on point, input only, connector index on the connected shape
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_CONNECTOR_LANE_PROFILE "unreal_zone_shape_connector_lane_profile"   // s@unreal_zone_shape_connector_lane_profile on point, input only, lane profile name of the connector
+#define HAPI_ATTRIB_UNREAL_ZONE_SHAPE_GRID_SIZE      "unreal_zone_shape_grid_size"   // f@unreal_zone_shape_grid_size on detail, split curves into grid cells (actors by default) by their bounds center, if no split values
 #define HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE         "unreal_zone_lane_profile"   // Define lanes, use d[]@unreal_zone_lane_profile to find or create LaneProfiles
 #define HAPI_ATTRIB_UNREAL_ZONE_LANE_PROFILE_NAME    "unreal_zone_lane_profile_name"   // use s@unreal_zone_lane_profile_name to specify exists LaneProfiles, or name the created LaneProfiles
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_WIDTH           "unreal_zone_lane_width"   // f[]@unreal_zone_lane_width, numeric alternative of d[]@unreal_zone_lane_profile, one width per lane
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_DIRECTION       "unreal_zone_lane_direction"   // i[]@unreal_zone_lane_direction, optional, same array size as i[]@unreal_zone_lane_width
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_TAGS            "unreal_zone_lane_tags"   // i[]@unreal_zone_lane_tags, optional, zone graph tag mask of each lane
+#define HAPI_ATTRIB_UNREAL_OUTPUT_ZONE_GRAPH         "unreal_output_zone_graph"   // i@unreal_output_zone_graph on detail, each curve is a lane written into AZoneGraphData directly
+#define HAPI_ATTRIB_UNREAL_ZONE_GRAPH_ZONE           "unreal_zone_graph_zone"   // i@unreal_zone_graph_zone, optional, lanes with the same value belong to the same zone
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_OUTGOING        "unreal_zone_lane_outgoing"   // i[]@unreal_zone_lane_outgoing, prim indices of the lanes connected to the end, incoming links are derived
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_INCOMING        "unreal_zone_lane_incoming"   // i[]@unreal_zone_lane_incoming, input only, prim indices of the lanes connected to the start
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_PROGRESSION     "unreal_zone_lane_progression"   // f@unreal_zone_lane_progression on point, input only, distance along the lane
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_LEFT            "unreal_zone_lane_left"   // i@unreal_zone_lane_left, optional, prim index of the adjacent left lane
+#define HAPI_ATTRIB_UNREAL_ZONE_LANE_RIGHT           "unreal_zone_lane_right"   // i@unreal_zone_lane_right, optional, prim index of the adjacent right lane
+
+
+DECLARE_STATS_GROUP(TEXT("Houdini Mass"), STATGROUP_HoudiniMass, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Direct HAPI Calls"), STAT_HoudiniMass_HapiCalls, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HAPI Helper Calls"), STAT_HoudiniMass_HapiHelperCalls, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);  // Each makes one or more HAPI calls
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Input Shapes"), STAT_HoudiniMass_InputShapes, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Input Points"), STAT_HoudiniMass_InputPoints, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Output Curves"), STAT_HoudiniMass_OutputCurves, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Output Points"), STAT_HoudiniMass_OutputPoints, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Unique Lanes"), STAT_HoudiniMass_UniqueLanes, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lane Profiles Created"), STAT_HoudiniMass_LaneProfilesCreated, STATGROUP_HoudiniMass, HOUDINIMASSTRANSLATOR_API);
+
+// Same as HAPI_SESSION_FAIL_RETURN, but also counts the HAPI call
+#define HOUDINI_MASS_HAPI_FAIL_RETURN(HAPI_FUNC_CALL) do { INC_DWORD_STAT(STAT_HoudiniMass_HapiCalls); HAPI_SESSION_FAIL_RETURN(HAPI_FUNC_CALL); } while (0)
+
+// Same as HOUDINI_FAIL_RETURN, but also counts the call of a HAPI helper of Houdini Engine plugin
+#define HOUDINI_MASS_HAPI_HELPER_FAIL_RETURN(HAPI_HELPER_CALL) do { INC_DWORD_STAT(STAT_HoudiniMass_HapiHelperCalls); HOUDINI_FAIL_RETURN(HAPI_HELPER_CALL); } while (0)
@@ -0,0 +1,26 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "ZoneGraphTypes.h"
+
+
+// Batch conversions between unreal and houdini space, swizzle and scale are folded into VectorRegister math,
+// so they run on SSE/AVX/NEON, or the FPU fallback of VectorRegister. All thread-safe
+namespace HoudiniMassConversion
+{
+	// OutData = Swizzle(Transform.TransformPosition(Point.Position) * POSITION_SCALE_TO_HOUDINI), 3 floats per point
+	HOUDINIMASSTRANSLATOR_API void PositionsToHoudini(const FTransform& Transform, const TConstArrayView<FZoneShapePoint>& Points, float* OutData);
+
+	// OutData = Swizzle(Transform.TransformRotation(Point.Rotation.Quaternion())), 4 floats per point
+	HOUDINIMASSTRANSLATOR_API void RotationsToHoudini(const FTransform& Transform, const TConstArrayView<FZoneShapePoint>& Points, float* OutData);
+
+	// Point.Position = Swizzle(Data) * POSITION_SCALE_TO_UNREAL, 3 floats per point
+	HOUDINIMASSTRANSLATOR_API void PositionsToUnreal(const float* Data, const TArrayView<FZoneShapePoint>& OutPoints);
+
+	// p@rot, the same as FQuat(Data[0], Data[2], Data[1], -Data[3]).Rotator(), 4 quats at a time
+	HOUDINIMASSTRANSLATOR_API void QuatsToRotators(const float* Data, const int32& Num, FRotator* OutRots);
+
+	// v@rot in radians, the same as FRotator(RadiansToDegrees(Data[0]), RadiansToDegrees(Data[2]), RadiansToDegrees(Data[1]))
+	HOUDINIMASSTRANSLATOR_API void EulersToRotators(const float* Data, const int32& Num, FRotator* OutRots);
+}
@@ -0,0 +1,40 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DeveloperSettings.h"
+
+#include "HoudiniMassSettings.generated.h"
+
+
+UENUM()
+enum class EHoudiniZoneShapeInputNodeMode : uint8
+{
+	Single,  // All zone shapes of an input are uploaded into a single node
+	PerShape,  // Each zone shape has its own node under the merge, so editing a shape only dirties its own node
+	PerCell  // Zone shapes are bucketed into grid cells by their bounds, each cell has its own node under the merge
+};
+
+UCLASS(Config = Editor, DefaultConfig, meta = (DisplayName = "Houdini Mass Translator"))
+class HOUDINIMASSTRANSLATOR_API UHoudiniMassSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	UPROPERTY(Config, EditAnywhere, Category = "Zone Shape Input")
+	EHoudiniZoneShapeInputNodeMode ZoneShapeInputNodeMode = EHoudiniZoneShapeInputNodeMode::Single;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Zone Shape Input", meta = (ClampMin = "100.0", Units = "cm",
+		EditCondition = "ZoneShapeInputNodeMode == EHoudiniZoneShapeInputNodeMode::PerCell"))
+	float ZoneShapeInputCellSize = 10000.0f;
+
+	// Apply zone shape outputs across several frames, so that the editor stays responsive on large outputs
+	UPROPERTY(Config, EditAnywhere, Category = "Zone Shape Output")
+	bool bTimeSliceZoneShapeOutput = false;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Zone Shape Output", meta = (ClampMin = "1.0", Units = "ms",
+		EditCondition = "bTimeSliceZoneShapeOutput"))
+	float ZoneShapeOutputFrameBudget = 10.0f;
+};
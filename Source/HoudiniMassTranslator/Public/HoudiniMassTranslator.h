@@ -4,13 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
 
 
 struct FZoneGraphBuildData;
+class AZoneGraphData;
+class FObjectPreSaveContext;
+class FObjectPostSaveContext;
 class SNotificationItem;
 
 class FHoudiniZoneShapeComponentInputBuilder;
+class FHoudiniZoneGraphDataInputBuilder;
 class FHoudiniZoneShapeOutputBuilder;
+class FHoudiniZoneGraphOutputBuilder;
+class FHoudiniZoneGraphSettingsCache;
+class FHoudiniZoneShapeOutputTask;
+class FHoudiniZoneShapeSpatialIndex;
 
 class FHoudiniMassTranslator : public IModuleInterface
 {
@@ -23,18 +32,58 @@ public:
 
 	void OnZoneShapeOutputFinish();
 
+	void AddZoneShapeOutputTask(const TSharedPtr<FHoudiniZoneShapeOutputTask>& Task);  // Will be processed within the frame budget on each tick
+
+	void FlushZoneShapeOutputTasks();  // Finish all time-sliced outputs now, so that no output holder refers to a component that has NOT been created
+
+	FORCEINLINE FHoudiniZoneGraphSettingsCache& GetZoneGraphSettingsCache() const { return *ZoneGraphSettingsCache; }
+
+	FORCEINLINE FHoudiniZoneShapeSpatialIndex& GetZoneShapeSpatialIndex() const { return *ZoneShapeSpatialIndex; }
+
 protected:
 	static FHoudiniMassTranslator* HoudiniMassTranslatorInstance;
 
 	TSharedPtr<FHoudiniZoneShapeComponentInputBuilder> ComponentInputBuilder;
 
+	TSharedPtr<FHoudiniZoneGraphDataInputBuilder> ZoneGraphInputBuilder;
+
 	TSharedPtr<FHoudiniZoneShapeOutputBuilder> OutputBuilder;
 
+	TSharedPtr<FHoudiniZoneGraphOutputBuilder> ZoneGraphOutputBuilder;
+
+	TSharedPtr<FHoudiniZoneGraphSettingsCache> ZoneGraphSettingsCache;
+
+	TSharedPtr<FHoudiniZoneShapeSpatialIndex> ZoneShapeSpatialIndex;
+
 	TSharedPtr<FUICommandList> Commands;
 	
 	TWeakPtr<SNotificationItem> Notification;
 
+	void AddNotification(const FText& Text);
+
+	TArray<TSharedPtr<FHoudiniZoneShapeOutputTask>> ZoneShapeOutputTasks;
+
+	bool bZoneShapeOutputTasksChanged = false;  // Whether any finished task has changed shapes, then we should ask to build zone graph
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	bool OnTick(float DeltaTime);
+
 	void OnZoneGraphBuildDone(const FZoneGraphBuildData&);
 
+	void OnZoneGraphDataAdded(const AZoneGraphData* ZoneGraphData);
+
 	void OnZoneGraphBuildCancel(const bool);
+
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent&);
+
+	void OnPreSaveWorld(UWorld*, FObjectPreSaveContext);
+
+	void OnPreBeginPIE(const bool);
+
+	void OnMapChange(uint32);
+
+	void OnLevelRemovedFromWorld(ULevel*, UWorld*);
+
+	void OnPackageSaved(const FString&, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
 };
@@ -0,0 +1,63 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "ZoneGraphTypes.h"
+
+#include "HoudiniOutput.h"
+
+#include "HoudiniOutputZoneGraph.generated.h"
+
+
+class AZoneGraphData;
+
+// Lanes computed by houdini are written into an AZoneGraphData directly, no zone shape components, no zone graph build
+UCLASS()
+class HOUDINIMASSTRANSLATOR_API UHoudiniOutputZoneGraph : public UHoudiniOutput
+{
+	GENERATED_BODY()
+
+protected:
+	UPROPERTY()
+	TSoftObjectPtr<AZoneGraphData> ZoneGraphData;
+
+	// "Build Zone Graph" also builds the zone shapes of the level into ZoneGraphData, so we keep a copy to restore.
+	// NOT serialized nor transacted, captured from ZoneGraphData when loaded, as ZoneGraphData has already saved the lanes
+	FZoneGraphStorage Storage;
+
+	uint32 StorageHash = 0;
+
+	bool bStorageCaptured = false;
+
+	static uint32 GetStorageHash(const FZoneGraphStorage& InStorage);
+
+	void CommitStorage();  // Write Storage into ZoneGraphData, will spawn one if not exists
+
+public:
+	virtual bool HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos) override;
+
+	virtual void Destroy() const override;
+
+	virtual void CollectActorSplitValues(TSet<FString>& InOutSplitValues, TSet<FString>& InOutEditableSplitValues) const override {}
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditUndo() override;
+#endif
+
+	void CaptureStorage();  // Should call when ZoneGraphData is loaded, will NOT recapture unless undone
+
+	void RestoreStorage(const UWorld* BuiltWorld);  // After zone graph build, only if ZoneGraphData is in BuiltWorld and has been overwritten, never spawns
+
+	FORCEINLINE const TSoftObjectPtr<AZoneGraphData>& GetZoneGraphData() const { return ZoneGraphData; }
+};
+
+
+class HOUDINIMASSTRANSLATOR_API FHoudiniZoneGraphOutputBuilder : public IHoudiniOutputBuilder
+{
+public:
+	virtual bool HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput) override;
+
+	virtual TSubclassOf<UHoudiniOutput> GetClass() const override { return UHoudiniOutputZoneGraph::StaticClass(); }
+};
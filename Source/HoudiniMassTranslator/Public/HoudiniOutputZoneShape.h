@@ -2,12 +2,18 @@
 
 #pragma once
 
+#include "ZoneGraphTypes.h"
+#include "ZoneShapeComponent.h"
+
 #include "HoudiniOutput.h"
+#include "HoudiniLaneProfileRegistry.h"
 
 #include "HoudiniOutputZoneShape.generated.h"
 
 
 class UZoneShapeComponent;
+class FHoudiniAttribute;
+class FHoudiniZoneShapeOutputTask;
 
 USTRUCT()
 struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeOutput : public FHoudiniComponentOutput
@@ -17,7 +23,14 @@ struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeOutput : public FHoudiniCompon
 protected:
 	mutable TWeakObjectPtr<UZoneShapeComponent> Component;
 
+	UPROPERTY()
+	int32 ShapeId = -1;  // From i@unreal_zone_shape_id, -1 means no stable id
+
 public:
+	FORCEINLINE const int32& GetShapeId() const { return ShapeId; }
+
+	FORCEINLINE void SetShapeId(const int32& InShapeId) { ShapeId = InShapeId; }
+
 	UZoneShapeComponent* Find(const AHoudiniNode* Node) const;
 
 	UZoneShapeComponent* CreateOrUpdate(AHoudiniNode* Node, const FString& InSplitValue, const bool& bSplitToActors);
@@ -30,16 +43,39 @@ class HOUDINIMASSTRANSLATOR_API UHoudiniOutputZoneShape : public UHoudiniOutput
 {
 	GENERATED_BODY()
 
+	friend class FHoudiniZoneShapeOutputTask;
+
 protected:
 	UPROPERTY()
 	TArray<FHoudiniZoneShapeOutput> ZoneShapeOutputs;
 
+	UPROPERTY()
+	TArray<FHoudiniLaneProfileReferences> LaneProfileReferences;  // Sorted by split value, registered into UHoudiniLaneProfileRegistry
+
+	TSharedPtr<FHoudiniZoneShapeOutputTask> PendingTask;  // Time-sliced apply that has not finished yet
+
+	void FlushPendingTask();
+
 public:
+	void RegisterLaneProfileReferences() const;  // Also refreshes the package that the registry records
+
+	void RecoverLaneProfileReferences();  // Outputs saved before references were recorded, rebuild them from the components
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PreEditUndo() override;
+
+	virtual void PostEditUndo() override;
+#endif
+
 	virtual bool HapiUpdate(const HAPI_GeoInfo& GeoInfo, const TArray<HAPI_PartInfo>& PartInfos) override;
 
 	virtual void Destroy() const override;
 
 	virtual void CollectActorSplitValues(TSet<FString>& InOutSplitValues, TSet<FString>& InOutEditableSplitValues) const override;
+
+	FORCEINLINE const TArray<FHoudiniZoneShapeOutput>& GetZoneShapeOutputs() const { return ZoneShapeOutputs; }
 };
 
 
@@ -49,4 +85,172 @@ public:
 	virtual bool HapiIsPartValid(const int32& NodeId, const HAPI_PartInfo& PartInfo, bool& bOutIsValid, bool& bOutShouldHoldByOutput) override;
 
 	virtual TSubclassOf<UHoudiniOutput> GetClass() const override { return UHoudiniOutputZoneShape::StaticClass(); }
-};
\ No newline at end of file
+};
+
+
+struct FHoudiniZoneShapeCurves  // Curves of a split value in a part
+{
+	FHoudiniZoneShapeCurves(const int8& UpdateMode, const FString& InSplitValue) :
+		PartialOutputMode(UpdateMode), SplitValue(InSplitValue) {}
+
+	int8 PartialOutputMode = 0;
+	FString SplitValue;
+
+	TArray<int32> CurveIndices;
+};
+
+struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapePointPropertySetter  // Compiled from a vertex or point unreal_uproperty_* attribute, sets a property of FZoneShapePoint directly
+{
+	bool Init(const FName& PropertyName);  // Returns false if the property is NOT a numeric, enum or bool property of FZoneShapePoint
+
+	void Set(const TArrayView<FZoneShapePoint>& Points, const int32& StartVertexIdx) const;  // Thread-safe
+
+	enum class EType : uint8
+	{
+		Float,
+		Double,
+		Int32,
+		UInt8,
+		Bool,
+		Numeric
+	};
+
+	EType Type = EType::Numeric;
+	const FProperty* Property = nullptr;
+	const FNumericProperty* NumericProperty = nullptr;  // Underlying property of enum
+	int32 Offset = 0;
+
+	HAPI_AttributeOwner Owner = HAPI_ATTROWNER_INVALID;
+	TArray<float> Data;
+};
+
+struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapePart  // Decoded data of a curve part, could be applied to components without HAPI
+{
+	FHoudiniZoneShapePart(const HAPI_PartInfo& PartInfo) : Info(PartInfo) {}
+
+	HAPI_PartInfo Info;
+	TArray<std::string> AttribNames;
+	TArray<int32> VertexIndices;  // Accumulate append CurveCounts
+	TMap<int32, FHoudiniZoneShapeCurves> SplitCurvesMap;
+	bool bGridCells = false;  // Split values are grid cells from f@unreal_zone_shape_grid_size
+
+	TArray<float> PositionData;  // Houdini space, 3 floats per point
+
+	HAPI_AttributeOwner RotOwner = HAPI_ATTROWNER_INVALID;
+	TArray<FRotator> Rots;
+
+	HAPI_AttributeOwner ZoneShapeTypeOwner = HAPI_ATTROWNER_INVALID;
+	TArray<int8> ZoneShapeTypes;
+
+	TArray<int32> PointLaneProfileIndices;  // On vertices or points
+	HAPI_AttributeOwner LaneProfileOwner = HAPI_ATTROWNER_INVALID;  // For Curve, maybe on prim or detail
+	TArray<int32> LaneProfileIndices;
+
+	HAPI_AttributeOwner ZoneGraphTagOwner = HAPI_ATTROWNER_INVALID;
+	TArray<FZoneGraphTagMask> ZoneGraphTags;
+
+	HAPI_AttributeOwner SplitActorsOwner = HAPI_ATTROWNER_INVALID;
+	TArray<int8> bSplitActors;
+
+	HAPI_AttributeOwner ShapeIdOwner = HAPI_ATTROWNER_INVALID;
+	TArray<int32> ShapeIds;
+
+	TArray<FHoudiniZoneShapePointPropertySetter> PointPropSetters;  // Applied in BuildPoints
+	TArray<TSharedPtr<FHoudiniAttribute>> PropAttribs;  // Those could NOT be compiled to PointPropSetters
+	TArray<const FProperty*> ComponentProperties;  // Properties of UZoneShapeComponent that prim or detail PropAttribs set
+	bool bHasUnknownComponentProperties = false;  // Some prim or detail PropAttribs set properties that are NOT in ComponentProperties, e.g. nested ones
+
+	// Thread-safe, Point.LaneProfile refers to OutPerPointLaneProfileIndices, which are indices of LaneProfiles
+	void BuildPoints(const int32& CurveIdx, const bool& bIsPolygon, const TArray<FZoneLaneProfile>& LaneProfiles,
+		TArray<FZoneShapePoint>& OutPoints, TArray<int32>& OutPerPointLaneProfileIndices) const;
+};
+
+// Decoded parts saved from HapiUpdate, could be replayed without houdini session by HoudiniMass.ReplayZoneShapeOutput
+struct HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeCapture
+{
+	TArray<FZoneLaneProfile> LaneProfiles;  // Lane profile indices of parts refer to this, UZoneGraphSettings lane profiles when captured
+	TArray<FHoudiniZoneShapePart> Parts;  // Without uproperty attributes, except PointPropSetters
+
+	static bool Save(const FString& FilePath, const TArray<FZoneLaneProfile>& InLaneProfiles, const TArray<FHoudiniZoneShapePart>& InParts);
+
+	bool Load(const FString& FilePath);
+
+protected:
+	static constexpr uint32 Magic = 0x4353485A;  // "ZHSC"
+	static constexpr int32 Version = 2;
+
+	static void Serialize(FArchive& Ar, TArray<FZoneLaneProfile>& InOutLaneProfiles, TArray<FHoudiniZoneShapePart>& InOutParts);
+};
+
+// Applies the decoded parts to zone shape components, could be processed across several frames to keep the editor responsive
+class HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeOutputTask
+{
+	friend class UHoudiniOutputZoneShape;
+
+public:
+	enum class EStage : uint8
+	{
+		BuildPoints,
+		Apply,
+		DestroyOld,
+		UpdateShape,
+		Finished
+	};
+
+	// For parts that are NOT retrieved from a houdini session, e.g. captures, benchmarks and tests. Each curve gets a new holder,
+	// and the old holders of Output will be destroyed. TransientLaneProfiles will be used instead of UZoneGraphSettings if set, should outlive the task
+	static TSharedPtr<FHoudiniZoneShapeOutputTask> Create(UHoudiniOutputZoneShape* InOutput, TArray<FHoudiniZoneShapePart>&& InParts,
+		const TArray<FZoneLaneProfile>* InTransientLaneProfiles = nullptr);
+
+	bool Process(const double& EndTime);  // Returns true when finished, always processes at least one curve or shape per call
+
+	void Cancel(const AHoudiniNode* Node);  // Destroy the old components that are still waiting for new ones
+
+	FORCEINLINE bool IsFinished() const { return Stage == EStage::Finished; }
+
+	FORCEINLINE bool HasChangedShapes() const { return !ChangedZSCs.IsEmpty(); }
+
+	float GetProgress() const;
+
+	FORCEINLINE const double& GetStageSeconds(const EStage& InStage) const { return StageSeconds[int32(InStage)]; }  // Accumulated across Process calls
+
+protected:
+	struct FCurve
+	{
+		int32 OutputIdx;
+		int32 PartIdx;
+		int32 CurveIdx;
+		bool bSplitActor;
+		const FString* SplitValue;  // Point to the FHoudiniZoneShapeCurves in Parts
+
+		bool bIsPolygon = false;  // The shape type that Points were built for
+		TArray<FZoneShapePoint> Points;  // Built on worker threads
+		TArray<int32> PerPointLaneProfileIndices;  // Indices of the lane profiles, Point.LaneProfile refers to this array
+	};
+
+	EStage Stage = EStage::BuildPoints;
+
+	TWeakObjectPtr<UHoudiniOutputZoneShape> Output;
+
+	TArray<FHoudiniZoneShapePart> Parts;
+
+	const TArray<FZoneLaneProfile>* TransientLaneProfiles = nullptr;  // Lane profile indices of Parts refer to this if set, else to UZoneGraphSettings
+
+	TArray<FCurve> Curves;
+
+	static constexpr int32 BuildPointsBatchSize = 1024;  // Curves built by a ParallelFor between two budget checks
+
+	int32 NumBuiltCurves = 0;
+
+	int32 NumAppliedCurves = 0;
+
+	TArray<FHoudiniZoneShapeOutput> OldOutputs;  // Not reused, should be destroyed after new components have been created
+
+	TMap<AActor*, TArray<FString>> ActorPropertyNamesMap;  // Use to avoid Set the same property in same SplitActor twice
+
+	TArray<TWeakObjectPtr<UZoneShapeComponent>> ChangedZSCs;
+
+	int32 NumUpdatedShapes = 0;
+
+	double StageSeconds[int32(EStage::Finished)] = {};
+};
@@ -0,0 +1,98 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "ZoneGraphTypes.h"
+
+
+class UZoneGraphSettings;
+
+// Data derived from UZoneGraphSettings that should live across uploads and cooks, owned by FHoudiniMassTranslator, game thread only
+class HOUDINIMASSTRANSLATOR_API FHoudiniZoneGraphSettingsCache
+{
+public:
+	static constexpr float LaneWidthTolerance = 0.1f;  // cm, widths are quantized by this, so float noise from unit conversion will NOT create another lane profile
+
+	FORCEINLINE static int32 QuantizeLaneWidth(const float& Width) { return FMath::RoundToInt32(Width / LaneWidthTolerance); }
+
+	FORCEINLINE static FZoneGraphTagMask CanonicalizeTags(const FZoneGraphTagMask& Tags) { return (Tags == FZoneGraphTagMask(0)) ? FZoneGraphTagMask(1) : Tags; }  // Empty tags means the default tag, like lane json
+
+	FORCEINLINE static void CanonicalizeLane(FZoneLaneDesc& InOutLane)  // Quantize width, clamp direction, and canonicalize tags
+	{
+		InOutLane.Width = QuantizeLaneWidth(InOutLane.Width) * LaneWidthTolerance;
+		InOutLane.Direction = EZoneLaneDirection(FMath::Clamp(int32(InOutLane.Direction), 0, 2));
+		InOutLane.Tags = CanonicalizeTags(InOutLane.Tags);
+	}
+
+	FORCEINLINE static uint32 GetLaneHash(const FZoneLaneDesc& Lane)  // Hash fields one by one, so that no allocation and no padding bytes, width is quantized
+	{
+		return HashCombineFast(HashCombineFast(GetTypeHash(QuantizeLaneWidth(Lane.Width)), GetTypeHash(uint8(Lane.Direction))), GetTypeHash(Lane.Tags.GetValue()));
+	}
+
+	FORCEINLINE static bool IsLaneEquivalent(const FZoneLaneDesc& A, const FZoneLaneDesc& B)  // Consistent with GetLaneHash
+	{
+		return (QuantizeLaneWidth(A.Width) == QuantizeLaneWidth(B.Width)) && (A.Direction == B.Direction) && (A.Tags == B.Tags);
+	}
+
+	static bool IsLaneProfileEquivalent(const TArray<FZoneLaneDesc>& A, const TArray<FZoneLaneDesc>& B);
+
+	FORCEINLINE static uint32 GetLaneProfileHash(const TArray<FZoneLaneDesc>& Lanes)
+	{
+		uint32 Hash = GetTypeHash(Lanes.Num());
+		for (const FZoneLaneDesc& Lane : Lanes)
+			Hash = HashCombineFast(Hash, GetLaneHash(Lane));
+		return Hash;
+	}
+
+	void Refresh(const UZoneGraphSettings* ZoneGraphSettings);  // Should call before using encodings, will flush the lane encodings if tags changed
+
+	int32 FindOrAddLaneEncoding(const FZoneLaneDesc& Lane);  // Returns the index of the encoded json str, like {"Width":350.0,"Direction":1,"Tags":["Vehicle"]}
+
+	int32 FindOrAddNameEncoding(const FName& Name);
+
+	// Returned str will be invalid after next FindOrAdd, so please FindOrAdd all, then Get
+	FORCEINLINE const char* GetLaneEncoding(const int32& EncodingIdx) const { return LaneEncodings[EncodingIdx].GetData(); }
+
+	FORCEINLINE const char* GetNameEncoding(const int32& EncodingIdx) const { return NameEncodings[EncodingIdx].GetData(); }
+
+	FORCEINLINE int32 GetNumLaneEncodings() const { return LaneEncodings.Num(); }
+
+	int32 FindLaneProfile(const UZoneGraphSettings* ZoneGraphSettings, const TArray<FZoneLaneDesc>& Lanes, const uint32& LanesHash);  // Returns INDEX_NONE if not found
+
+	int32 AddLaneProfile(UZoneGraphSettings* ZoneGraphSettings, const FZoneLaneProfile& NewLaneProfile);  // Returns the index of the new lane profile
+
+	int32 FindLaneProfileByName(const UZoneGraphSettings* ZoneGraphSettings, const FName& LaneProfileName);  // Returns INDEX_NONE if not found
+
+	FZoneGraphTagMask FindOrCreateTag(UZoneGraphSettings* ZoneGraphSettings, const FName& TagName, bool& bZoneGraphSettingsModified);
+
+	FORCEINLINE void InvalidateLaneProfiles() { HashProfileIdxMap.Empty(); NameProfileIdxMap.Empty(); NumIndexedProfiles = 0; }  // Should call after lane profiles removed or renamed
+
+protected:
+	struct FLaneKeyFuncs : TDefaultMapKeyFuncs<FZoneLaneDesc, int32, false>
+	{
+		FORCEINLINE static uint32 GetKeyHash(const FZoneLaneDesc& Key) { return GetLaneHash(Key); }
+	};
+
+	static constexpr int32 MaxTags = 32;  // FZoneGraphTagMask is uint32
+
+	FName TagNames[MaxTags];  // Tag bit -> Tag name
+
+	TMap<FZoneLaneDesc, int32, FDefaultSetAllocator, FLaneKeyFuncs> LaneEncodingIdxMap;
+
+	TArray<TArray<ANSICHAR>> LaneEncodings;
+
+	TMap<FName, int32> NameEncodingIdxMap;
+
+	TArray<TArray<ANSICHAR>> NameEncodings;
+
+	// Lane profiles hash index, lane profiles are usually only appended, so we index the new ones incrementally
+	TMultiMap<uint32, int32> HashProfileIdxMap;
+
+	TMap<FName, int32> NameProfileIdxMap;  // Only the first lane profile with the name, the same as IndexOfByPredicate
+
+	int32 NumIndexedProfiles = 0;
+
+	TMap<FName, uint8> NameTagMap;  // Tag name -> Tag bit, verified by GetTagInfos() when hit
+
+	void UpdateLaneProfileIndex(const UZoneGraphSettings* ZoneGraphSettings);
+};
@@ -0,0 +1,33 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "Components/BoxComponent.h"
+#include "GameFramework/Actor.h"
+
+#include "HoudiniZoneShapeRegion.generated.h"
+
+
+// When the actor is set as a houdini input, all zone shapes in the world that intersect this box will be uploaded,
+// shapes that cross the box boundary will have i@unreal_zone_shape_clipped = 1
+UCLASS(ClassGroup = HoudiniMass, meta = (BlueprintSpawnableComponent))
+class HOUDINIMASSTRANSLATOR_API UHoudiniZoneShapeRegionComponent : public UBoxComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHoudiniZoneShapeRegionComponent();
+};
+
+UCLASS(meta = (DisplayName = "Houdini Zone Shape Region"))
+class HOUDINIMASSTRANSLATOR_API AHoudiniZoneShapeRegion : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AHoudiniZoneShapeRegion();
+
+protected:
+	UPROPERTY(VisibleAnywhere, Category = "Houdini Zone Shape Region")
+	TObjectPtr<UHoudiniZoneShapeRegionComponent> Region;
+};
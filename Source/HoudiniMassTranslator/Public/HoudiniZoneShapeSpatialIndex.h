@@ -0,0 +1,79 @@
+// Copyright (c) <2025> Yuzhe Pan (childadrianpan@gmail.com). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+class UZoneShapeComponent;
+class ULevel;
+
+// Uniform grid of the world bounds of all zone shape components in the editor world, owned by FHoudiniMassTranslator, game thread only.
+// Moved, edited or houdini output shapes are re-indexed incrementally, added or removed actors and levels will rebuild the grid lazily on the next query
+class HOUDINIMASSTRANSLATOR_API FHoudiniZoneShapeSpatialIndex
+{
+public:
+	void Initialize();  // Bind editor delegates
+
+	void Deinitialize();
+
+	void Query(const UWorld* World, const FBox& WorldBox, TArray<const UZoneShapeComponent*>& OutComponents);  // Components whose bounds intersect WorldBox
+
+	FORCEINLINE void MarkDirty() { bDirty = true; }
+
+	void Update(const UZoneShapeComponent* ZSC);
+
+	// Conservative bounds of the shape in the space of Transform: bezier control points, padded by half the total width of its widest lane profile
+	static FBox GetBounds(const UZoneShapeComponent* ZSC, const FTransform& Transform);
+
+	static FBox GetWorldBounds(const UZoneShapeComponent* ZSC);
+
+protected:
+	static constexpr double CellSize = 10000.0;  // cm
+
+	struct FEntry
+	{
+		TWeakObjectPtr<const UZoneShapeComponent> Component;
+		FBox Bounds;
+	};
+
+	TWeakObjectPtr<const UWorld> IndexedWorld;
+
+	bool bDirty = true;
+
+	TArray<FEntry> Entries;
+
+	TArray<int32> FreeEntryIndices;
+
+	TMap<const UZoneShapeComponent*, int32> ComponentEntryIdxMap;
+
+	TMap<FIntPoint, TArray<int32>> Cells;  // Cell coord on XY -> Entry indices
+
+	void Rebuild(const UWorld* World);
+
+	void AddEntry(const UZoneShapeComponent* ZSC);
+
+	void RemoveEntry(const int32& EntryIdx);
+
+	template<typename TFunc>
+	FORCEINLINE static void ForEachCell(const FBox& Box, const TFunc& Func)
+	{
+		const int32 MinX = FMath::FloorToInt32(Box.Min.X / CellSize);
+		const int32 MinY = FMath::FloorToInt32(Box.Min.Y / CellSize);
+		const int32 MaxX = FMath::FloorToInt32(Box.Max.X / CellSize);
+		const int32 MaxY = FMath::FloorToInt32(Box.Max.Y / CellSize);
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			for (int32 X = MinX; X <= MaxX; ++X)
+				Func(FIntPoint(X, Y));
+		}
+	}
+
+	void OnActorChanged(AActor* Actor);
+
+	void OnActorMoved(AActor* Actor);
+
+	void OnLevelChanged(ULevel*, UWorld*);
+
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent&);
+};